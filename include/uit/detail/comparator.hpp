@@ -0,0 +1,57 @@
+// SPDX-FileCopyrightText: 2025 TypeCombinator <typecombinator@foxmail.com>
+//
+// SPDX-License-Identifier: BSD 3-Clause
+
+#ifndef UIT_DETAIL_COMPARATOR_B62E04D9_7F1A_4C38_9E5B_A03D8C6F2E71
+#define UIT_DETAIL_COMPARATOR_B62E04D9_7F1A_4C38_9E5B_A03D8C6F2E71
+#include <compare>
+#include <concepts>
+#include <functional>
+
+namespace uit { namespace detail {
+template <typename CMP, typename A, typename B>
+concept three_way_comparator = requires(const CMP &cmp, const A &a, const B &b) {
+    { cmp(a, b) } -> std::convertible_to<std::partial_ordering>;
+};
+
+template <typename CMP>
+constexpr bool is_std_less_v = false;
+
+template <typename T>
+constexpr bool is_std_less_v<std::less<T>> = true;
+
+// The CMP of trees is either a "less" or a three-way comparator that returns an ordering, such as
+// std::compare_three_way. The call operator is always a "less", and compare() returns an ordering,
+// so a descent that must detect the equivalence only takes one three-way comparison per level. If
+// CMP is std::less and the operands have operator<=>, it's used by compare() as well.
+template <typename CMP>
+struct comparator {
+    template <typename A, typename B>
+    constexpr bool operator()(const A &a, const B &b) const {
+        if constexpr (three_way_comparator<CMP, A, B>) {
+            return cmp(a, b) < 0;
+        } else {
+            return cmp(a, b);
+        }
+    }
+
+    template <typename A, typename B>
+    constexpr auto compare(const A &a, const B &b) const {
+        if constexpr (three_way_comparator<CMP, A, B>) {
+            return cmp(a, b);
+        } else if constexpr (is_std_less_v<CMP> && std::three_way_comparable_with<A, B>) {
+            return a <=> b;
+        } else {
+            if (cmp(a, b)) {
+                return std::weak_ordering::less;
+            }
+            return cmp(b, a) ? std::weak_ordering::greater : std::weak_ordering::equivalent;
+        }
+    }
+
+    // TODO: need a macro for the msvc.
+    [[no_unique_address]]
+    CMP cmp;
+};
+}} // namespace uit::detail
+#endif // comparator.hpp
@@ -0,0 +1,161 @@
+// SPDX-FileCopyrightText: 2025 TypeCombinator <typecombinator@foxmail.com>
+//
+// SPDX-License-Identifier: BSD 3-Clause
+
+#ifndef UIT_DETAIL_DARY_HEAP_CE3200AB_3881_44EE_A85F_DDD1C3F0C112
+#define UIT_DETAIL_DARY_HEAP_CE3200AB_3881_44EE_A85F_DDD1C3F0C112
+#include <uit/intrusive.hpp>
+#include <bit>
+#include <type_traits>
+
+namespace uit { namespace detail {
+// The slot of the key-inline layout, the key is compared without touching the node.
+template <typename K, typename T>
+struct key_slot {
+    K key;
+    T *node;
+};
+
+// The sifts of the indexed d-ary heap, they're shared by the storages of idheap. A storage is
+// reached by Slots, which returns the address of the slot of an index, and the Arity children of
+// a node must be adjacent, so the minimum is found in place. A slot is either the node pointer or
+// a key_slot.
+template <auto Index, unsigned Arity, typename CMP, typename Slot = container_t<Index> *>
+struct dary_heap;
+
+template <typename T, typename MT, MT T::*Index, unsigned Arity, typename CMP, typename Slot>
+struct dary_heap<Index, Arity, CMP, Slot> {
+    static_assert(
+        (Arity >= 2) && (Arity <= 16) && std::has_single_bit(Arity),
+        "The arity must be 2, 4, 8 or 16.");
+    static_assert(
+        std::is_unsigned_v<MT>,
+        "The index member must be unsigned, the indices are shifted and measured by std::bit_width.");
+
+    using np_t = T *;
+    using index_t = MT;
+    using slot_t = Slot;
+
+    static constexpr unsigned arity_bits = std::countr_zero(Arity);
+
+    static constexpr index_t parent_index(index_t index) noexcept {
+        return (index - 1) >> arity_bits;
+    }
+
+    static constexpr index_t child0_index(index_t index) noexcept {
+        return (index << arity_bits) + index_t{1};
+    }
+
+    static np_t node_of(const slot_t &slot) noexcept {
+        if constexpr (std::is_pointer_v<slot_t>) {
+            return slot;
+        } else {
+            return slot.node;
+        }
+    }
+
+    static bool less(const slot_t &a, const slot_t &b) noexcept {
+        if constexpr (std::is_pointer_v<slot_t>) {
+            return CMP{}(*a, *b);
+        } else {
+            return CMP{}(a.key, b.key);
+        }
+    }
+
+    template <typename Slots>
+    static inline void sift_up(const Slots &slots, slot_t cur, index_t cur_idx) noexcept {
+        index_t parent_idx;
+        slot_t parent;
+        while (cur_idx > 0) {
+            parent_idx = parent_index(cur_idx);
+            parent = *slots(parent_idx);
+            if (!less(cur, parent)) {
+                break;
+            }
+            *slots(cur_idx) = parent;
+            node_of(parent)->*Index = cur_idx;
+            cur_idx = parent_idx;
+        }
+        *slots(cur_idx) = cur;
+        node_of(cur)->*Index = cur_idx;
+    }
+
+    // Floyd's heapify costs O(n) for the n nodes in all, the sift ups of the k new nodes cost
+    // O(k log n) in the worst case, so the heapify is taken when the batch isn't much smaller.
+    static constexpr bool prefers_heapify(index_t size, index_t count) noexcept {
+        index_t total = size + count;
+        index_t depth = static_cast<index_t>(std::bit_width(total) / arity_bits + 1);
+        return count >= total / depth;
+    }
+
+    // Floyd's heapify, the slots of the size nodes are filled and their indices are written, the
+    // parents are sifted down from the last one to the root.
+    template <typename Slots>
+    static inline void heapify(const Slots &slots, index_t size) noexcept {
+        if (size < 2) {
+            return;
+        }
+        for (index_t i = parent_index(size - 1) + 1; i-- > 0;) {
+            sift_down(slots, size, *slots(i), i);
+        }
+    }
+
+    // The minimum of N adjacent slots, it's a tournament unrolled at compile time, so the
+    // comparisons of a level are independent.
+    template <unsigned N>
+    static inline slot_t *min_of(slot_t *first_ptr) noexcept {
+        if constexpr (N == 1) {
+            return first_ptr;
+        } else {
+            slot_t *a = min_of<N / 2>(first_ptr);
+            slot_t *b = min_of<N / 2>(first_ptr + N / 2);
+            return less(*b, *a) ? b : a;
+        }
+    }
+
+    template <typename Slots>
+    static inline void
+        sift_down(const Slots &slots, index_t size, slot_t cur, index_t cur_idx) noexcept {
+        auto child_idx = child0_index(cur_idx);
+        slot_t *cur_ptr = slots(cur_idx);
+        slot_t *first_ptr;
+        slot_t *min_ptr;
+        while ((child_idx + (Arity - 1)) < size) {
+            first_ptr = slots(child_idx);
+            min_ptr = min_of<Arity>(first_ptr);
+            if (less(*min_ptr, cur)) {
+                *cur_ptr = *min_ptr;
+                node_of(*min_ptr)->*Index = cur_idx;
+                cur_idx = child_idx + static_cast<index_t>(min_ptr - first_ptr);
+                cur_ptr = min_ptr;
+
+                child_idx = child0_index(cur_idx);
+            } else {
+                *cur_ptr = cur;
+                node_of(cur)->*Index = cur_idx;
+                return;
+            }
+        }
+        if (child_idx < size) {
+            first_ptr = slots(child_idx);
+            min_ptr = first_ptr;
+            // TODO: UIT_ATTR_ASSUME(size - child_idx < Arity);
+            for (slot_t *child_ptr = first_ptr + 1; child_ptr < first_ptr + (size - child_idx);
+                 child_ptr++) {
+                if (less(*child_ptr, *min_ptr)) {
+                    min_ptr = child_ptr;
+                }
+            }
+            if (less(*min_ptr, cur)) {
+                *cur_ptr = *min_ptr;
+                node_of(*min_ptr)->*Index = cur_idx;
+                cur_idx = child_idx + static_cast<index_t>(min_ptr - first_ptr);
+                cur_ptr = min_ptr;
+            }
+        }
+        *cur_ptr = cur;
+        node_of(cur)->*Index = cur_idx;
+    }
+};
+}} // namespace uit::detail
+#endif // dary_heap.hpp
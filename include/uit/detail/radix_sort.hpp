@@ -0,0 +1,72 @@
+// SPDX-FileCopyrightText: 2025 TypeCombinator <typecombinator@foxmail.com>
+//
+// SPDX-License-Identifier: BSD 3-Clause
+
+#ifndef UIT_DETAIL_RADIX_SORT_2F7A9C31_84E6_4B0D_A1C5_6E9D3B7F0A28
+#define UIT_DETAIL_RADIX_SORT_2F7A9C31_84E6_4B0D_A1C5_6E9D3B7F0A28
+#include <uit/intrusive.hpp>
+#include <concepts>
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+namespace uit { namespace detail {
+// A stable LSD radix sort of node pointers by an integral key, 8 bits per pass. All histograms are
+// built in one scan, and the passes in which all keys have the same digit are skipped.
+template <auto Key, typename T>
+    requires std::integral<member_t<Key>>
+void radix_sort(T **first, T **last) {
+    using key_t = member_t<Key>;
+    using ukey_t = std::make_unsigned_t<key_t>;
+    constexpr unsigned passes = sizeof(key_t);
+    constexpr unsigned radix = 256;
+
+    std::size_t n = static_cast<std::size_t>(last - first);
+    if (n < 2) {
+        return;
+    }
+    auto ukey = [](const T *node) noexcept {
+        ukey_t k = static_cast<ukey_t>(node->*Key);
+        if constexpr (std::is_signed_v<key_t>) {
+            k ^= ukey_t{1} << (sizeof(key_t) * 8 - 1);
+        }
+        return k;
+    };
+
+    std::size_t counts[passes][radix]{};
+    for (T **i = first; i != last; i++) {
+        ukey_t k = ukey(*i);
+        for (unsigned p = 0; p < passes; p++) {
+            counts[p][(k >> (p * 8)) & (radix - 1)]++;
+        }
+    }
+
+    std::vector<T *> buffer(n);
+    T **src = first;
+    T **dst = buffer.data();
+    for (unsigned p = 0; p < passes; p++) {
+        std::size_t *count = counts[p];
+        if (count[(ukey(*src) >> (p * 8)) & (radix - 1)] == n) {
+            continue;
+        }
+        std::size_t offset = 0;
+        for (unsigned d = 0; d < radix; d++) {
+            std::size_t c = count[d];
+            count[d] = offset;
+            offset += c;
+        }
+        for (std::size_t i = 0; i < n; i++) {
+            dst[count[(ukey(src[i]) >> (p * 8)) & (radix - 1)]++] = src[i];
+        }
+        T **t = src;
+        src = dst;
+        dst = t;
+    }
+    if (src != first) {
+        for (std::size_t i = 0; i < n; i++) {
+            first[i] = src[i];
+        }
+    }
+}
+}} // namespace uit::detail
+#endif // radix_sort.hpp
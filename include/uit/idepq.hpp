@@ -0,0 +1,125 @@
+// SPDX-FileCopyrightText: 2025 TypeCombinator <typecombinator@foxmail.com>
+//
+// SPDX-License-Identifier: BSD 3-Clause
+
+#ifndef UIT_IDEPQ_3F8B21C7_5A0E_4D96_B4E2_C17D06A9F583
+#define UIT_IDEPQ_3F8B21C7_5A0E_4D96_B4E2_C17D06A9F583
+#include <uit/irwbt.hpp>
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <utility>
+
+// References:
+// [0] J. van Leeuwen and D. Wood. Interval Heaps. 1993.
+// Notices:
+// [0] The acronym idepq stands for intrusive double-ended priority queue.
+// [1] It's a facade over irwbt_cached rather than an interval heap, both ends are O(1) to peek and
+// O(log n) to pop, and any node can be erased in O(log n + d), see irwbt::erase.
+// [2] The min is the first node in the order of CMP. In the bounded mode, the queue keeps the
+// "capacity" smallest nodes, so the max is the worst one and it's evicted on overflow. Use
+// std::greater<> to keep the largest nodes.
+namespace uit {
+template <auto Right, auto Left, auto Size, typename CMP = std::less<>>
+class idepq;
+
+template <typename T, typename MT, MT T::*Right, MT T::*Left, auto Size, typename CMP>
+class idepq<Right, Left, Size, CMP> {
+    using tree_t = irwbt_cached<Right, Left, Size, CMP>;
+   public:
+    using np_t = T *;
+
+    idepq() noexcept
+        : m_capacity{std::numeric_limits<std::size_t>::max()} {
+    }
+
+    // The capacity must not be 0.
+    explicit idepq(std::size_t capacity) noexcept
+        : m_capacity{capacity} {
+    }
+
+    [[nodiscard]]
+    static idepq bounded(std::size_t capacity) noexcept {
+        return idepq{capacity};
+    }
+
+    [[nodiscard]]
+    bool empty() const noexcept {
+        return m_tree.empty();
+    }
+
+    [[nodiscard]]
+    std::size_t size() const noexcept {
+        return m_tree.size();
+    }
+
+    [[nodiscard]]
+    std::size_t capacity() const noexcept {
+        return m_capacity;
+    }
+
+    void clear() noexcept {
+        m_tree.clear();
+    }
+
+    template <typename Disposer>
+    void clear_and_dispose(Disposer &&disposer) {
+        m_tree.clear_and_dispose(std::forward<Disposer>(disposer));
+    }
+
+    // It's UB when the queue is empty, so you must check for emptiness before calling this function.
+    [[nodiscard]]
+    T &top_min() const noexcept {
+        return *m_tree.front();
+    }
+
+    // It's UB when the queue is empty, so you must check for emptiness before calling this function.
+    [[nodiscard]]
+    T &top_max() const noexcept {
+        return *m_tree.back();
+    }
+
+    // Returns nullptr if the node is pushed without overflow. On overflow, the worse one of the node
+    // and the max is returned, so the node itself is returned if it's rejected. The rejection only
+    // takes one comparison with the cached max, it's the common case for a long stream.
+    np_t push(np_t node) noexcept {
+        if (m_tree.size() < m_capacity) [[likely]] {
+            m_tree.insert_multi(node);
+            return nullptr;
+        }
+        // Equivalent nodes are rejected, the earlier one wins.
+        if (!cmp(*node, *m_tree.back())) {
+            return node;
+        }
+        // The max is evicted and the node is inserted in one descent.
+        return m_tree.replace_max(node);
+    }
+
+    // It's UB when the queue is empty, so you must check for emptiness before calling this function.
+    np_t pop_min() noexcept {
+        return m_tree.pop_front();
+    }
+
+    // It's UB when the queue is empty, so you must check for emptiness before calling this function.
+    np_t pop_max() noexcept {
+        return m_tree.pop_back();
+    }
+
+    // Remove exactly the node, returns false if it isn't in the queue.
+    bool erase(np_t node) noexcept {
+        return m_tree.erase(node);
+    }
+
+    template <typename F>
+    void for_each(F &&f) const {
+        m_tree.for_each(std::forward<F>(f));
+    }
+   private:
+    tree_t m_tree;
+    std::size_t m_capacity;
+    // TODO: need a macro for the msvc.
+    [[no_unique_address]]
+    detail::comparator<CMP> cmp;
+};
+} // namespace uit
+#endif // idepq.hpp
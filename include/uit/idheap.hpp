@@ -0,0 +1,743 @@
+// SPDX-FileCopyrightText: 2025 TypeCombinator <typecombinator@foxmail.com>
+//
+// SPDX-License-Identifier: BSD 3-Clause
+
+#ifndef UIT_IDHEAP_8B215864_4A15_495A_A1CE_5D6344DE5A9B
+#define UIT_IDHEAP_8B215864_4A15_495A_A1CE_5D6344DE5A9B
+#include <uit/intrusive.hpp>
+#include <uit/detail/dary_heap.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <cstring>
+#include <span>
+#include <utility>
+#include <type_traits>
+
+namespace uit {
+// Extra attribute that can be added to the allocator.
+template <typename T>
+struct no_expanding {
+    using type = T;
+};
+
+// Extra attribute that can be added to the allocator, the pointer array is kept in segments of
+// 2^SegmentBits pointers, so the growth allocates one segment and nothing is moved.
+template <typename T, unsigned SegmentBits = 12>
+struct segmented {
+    using type = T;
+    static constexpr unsigned segment_bits = SegmentBits;
+};
+
+// Extra attribute that can be added to the allocator, the storage holds the key of each node with
+// its pointer, so the comparisons don't load the nodes. Key is a member pointer or a captureless
+// lambda that projects the node to its key, and CMP compares the keys.
+template <typename T, auto Key>
+struct key_inline {
+    using type = T;
+};
+
+namespace detail {
+template <typename Allocator>
+constexpr bool is_segmented_v = false;
+
+template <typename Allocator, unsigned SegmentBits>
+constexpr bool is_segmented_v<segmented<Allocator, SegmentBits>> = true;
+
+template <typename Allocator>
+constexpr bool is_key_inline_v = false;
+
+template <typename Allocator, auto Key>
+constexpr bool is_key_inline_v<key_inline<Allocator, Key>> = true;
+
+// The storages of idheap, they're selected by the attribute of the allocator. A storage owns the
+// slots and the size, and provides:
+// - slot_t: the node pointer or a key_slot.
+// - slots(): the functor that returns the address of the slot of an index, see dary_heap.
+// - make_slot(node): the slot of a node.
+// - reserve(size): the capacity is made enough for the size, it isn't called if fixed_capacity.
+// - capacity(), slot_bytes: the capacity in nodes and the bytes of a slot.
+template <auto Index, unsigned Arity, typename Allocator>
+class idheap_storage;
+
+template <typename T, typename MT, MT T::* Index, unsigned Arity, typename Allocator>
+    requires(!is_segmented_v<Allocator> && !is_key_inline_v<Allocator>)
+class idheap_storage<Index, Arity, Allocator> {
+    using np_t = T*;
+    using index_t = MT;
+    static constexpr bool allocator_no_expanding =
+        is_template_instance_of_v<Allocator, no_expanding>;
+
+    template <typename U, bool Fixed>
+    struct allocator_selector;
+
+    template <typename U>
+    struct allocator_selector<U, true> {
+        using type = Allocator::type;
+    };
+
+    template <typename U>
+    struct allocator_selector<U, false> {
+        using type = Allocator;
+    };
+   public:
+    using slot_t = np_t;
+    using allocator_type = allocator_selector<int, allocator_no_expanding>::type;
+    static constexpr bool fixed_capacity = allocator_no_expanding;
+    static constexpr std::size_t slot_bytes = sizeof(slot_t);
+
+    [[nodiscard]]
+    index_t capacity() const noexcept {
+        return m_capacity;
+    }
+   protected:
+    using allocator_traits = std::allocator_traits<allocator_type>;
+    static constexpr bool allocator_pocma =
+        allocator_traits::propagate_on_container_move_assignment::value;
+    static constexpr bool allocator_always_equal = allocator_traits::is_always_equal::value;
+
+    struct contiguous_slots {
+        np_t* begin_ptr;
+
+        np_t* operator()(index_t index) const noexcept {
+            return begin_ptr + index;
+        }
+    };
+
+    explicit idheap_storage(index_t reserve, const allocator_type& alloc)
+        : m_storage{}
+        , m_allocator{alloc} {
+        m_storage = allocator_traits::allocate(m_allocator, reserve);
+        m_capacity = reserve;
+        m_size = 0;
+    }
+
+    idheap_storage(idheap_storage&& other) noexcept(
+        std::is_nothrow_move_constructible_v<allocator_type>)
+        : m_allocator(std::move(other.m_allocator)) {
+        m_storage = other.m_storage;
+        m_size = other.m_size;
+        m_capacity = other.m_capacity;
+
+        other.m_storage = nullptr;
+        // other.m_size = 0;
+    }
+
+    idheap_storage& operator=(idheap_storage&& other) noexcept(
+        allocator_pocma || allocator_always_equal) {
+        if (this == &other) [[unlikely]] {
+            return *this;
+        }
+        if constexpr (allocator_always_equal) {
+            std::swap(m_storage, other.m_storage);
+            std::swap(m_capacity, other.m_capacity);
+            std::swap(m_size, other.m_size);
+        } else if constexpr (allocator_pocma) {
+            allocator_traits::deallocate(m_allocator, m_storage, m_capacity);
+            m_allocator = std::move(other.m_allocator); // This can throw.
+            m_storage = other.m_storage;
+            m_capacity = other.m_capacity;
+            m_size = other.m_size;
+
+            other.m_storage = nullptr;
+            // other.m_size = 0;
+        } else {
+            if (m_allocator != other.m_allocator) {
+                if (allocator_no_expanding || (m_capacity >= other.m_size)) {
+                    // If the capacity is insufficient and expansion is prohibited, it is UB.
+                    std::memcpy(m_storage, other.m_storage, sizeof(np_t) * other.m_size);
+                    m_size = other.m_size;
+                } else {
+                    np_t* new_storage = allocator_traits::allocate(m_allocator, other.m_capacity);
+                    std::memcpy(new_storage, other.m_storage, sizeof(np_t) * other.m_size);
+                    allocator_traits::deallocate(m_allocator, m_storage, m_capacity);
+                    m_storage = new_storage;
+                    m_capacity = other.m_capacity;
+                    m_size = other.m_size;
+                }
+            } else {
+                std::swap(m_storage, other.m_storage);
+                std::swap(m_capacity, other.m_capacity);
+                std::swap(m_size, other.m_size);
+            }
+        }
+        return *this;
+    }
+
+    ~idheap_storage() {
+        if (m_storage != nullptr) {
+            allocator_traits::deallocate(m_allocator, m_storage, m_capacity);
+            m_storage = nullptr;
+        }
+    }
+
+    contiguous_slots slots() const noexcept {
+        return contiguous_slots{m_storage};
+    }
+
+    static slot_t make_slot(np_t node) noexcept {
+        return node;
+    }
+
+    // The capacity is doubled at least.
+    void reserve(index_t size) {
+        if (size > m_capacity) {
+            expand_capacity(std::max<index_t>(m_capacity * 2, size));
+        }
+    }
+
+    void expand_capacity(index_t grater_capacity) {
+        np_t* new_storage = allocator_traits::allocate(m_allocator, grater_capacity);
+
+        std::memcpy(new_storage, m_storage, sizeof(np_t) * m_capacity);
+        allocator_traits::deallocate(m_allocator, m_storage, m_capacity);
+        m_storage = new_storage;
+        m_capacity = grater_capacity;
+    }
+
+    // std::vector might be a better choice.
+    np_t* m_storage;
+    index_t m_size;
+    index_t m_capacity;
+    // TODO: Need a macro for msvc.
+    [[no_unique_address]]
+    allocator_type m_allocator;
+};
+
+// Notices:
+// [0] The segmented storage is a directory of segments, the growth only allocates a segment, and
+// the directory of n / 2^SegmentBits pointers is doubled when it's full, so there's no O(n) pause.
+// [1] The slot of the index i is i + d - 1 for the arity d, so the d children of a node, di + 1 to
+// di + d, are in the slots d(i + 1) to d(i + 1) + d - 1, they never cross a segment, and for the
+// arity 4 or less they share a cache line.
+// [2] The segments are kept until the heap is destroyed, like the contiguous storage.
+template <
+    typename T,
+    typename MT,
+    MT T::* Index,
+    unsigned Arity,
+    typename Allocator,
+    unsigned SegmentBits>
+class idheap_storage<Index, Arity, segmented<Allocator, SegmentBits>> {
+    using np_t = T*;
+    using index_t = MT;
+   public:
+    using slot_t = np_t;
+    using allocator_type = Allocator;
+    static constexpr bool fixed_capacity = false;
+    static constexpr std::size_t slot_bytes = sizeof(slot_t);
+
+    [[nodiscard]]
+    index_t capacity() const noexcept {
+        return (m_segment_count > 0) ? (m_segment_count * segment_size - slot_offset) : 0;
+    }
+   protected:
+    using allocator_traits = std::allocator_traits<allocator_type>;
+    using directory_allocator_type = allocator_traits::template rebind_alloc<np_t*>;
+    using directory_traits = std::allocator_traits<directory_allocator_type>;
+    static constexpr bool allocator_pocma =
+        allocator_traits::propagate_on_container_move_assignment::value;
+    static constexpr bool allocator_always_equal = allocator_traits::is_always_equal::value;
+
+    static_assert(
+        (SegmentBits >= std::countr_zero(Arity)) && (SegmentBits < sizeof(index_t) * 8),
+        "A segment must hold the children of a node.");
+    static constexpr index_t segment_size = index_t{1} << SegmentBits;
+    static constexpr index_t segment_mask = segment_size - 1;
+    static constexpr index_t slot_offset = Arity - 1;
+
+    struct segmented_slots {
+        np_t* const* segments;
+
+        np_t* operator()(index_t index) const noexcept {
+            index_t slot = index + slot_offset;
+            return segments[slot >> SegmentBits] + (slot & segment_mask);
+        }
+    };
+
+    explicit idheap_storage(index_t reserve, const allocator_type& alloc)
+        : m_segments{nullptr}
+        , m_size{0}
+        , m_segment_count{0}
+        , m_directory_capacity{0}
+        , m_allocator{alloc} {
+        reserve_segments(segment_count_of(reserve));
+    }
+
+    idheap_storage(idheap_storage&& other) noexcept(
+        std::is_nothrow_move_constructible_v<allocator_type>)
+        : m_segments{other.m_segments}
+        , m_size{other.m_size}
+        , m_segment_count{other.m_segment_count}
+        , m_directory_capacity{other.m_directory_capacity}
+        , m_allocator(std::move(other.m_allocator)) {
+        other.m_segments = nullptr;
+        other.m_size = 0;
+        other.m_segment_count = 0;
+        other.m_directory_capacity = 0;
+    }
+
+    idheap_storage& operator=(idheap_storage&& other) noexcept(
+        allocator_pocma || allocator_always_equal) {
+        if (this == &other) [[unlikely]] {
+            return *this;
+        }
+        if constexpr (allocator_always_equal) {
+            swap_storage(other);
+        } else if constexpr (allocator_pocma) {
+            release();
+            m_allocator = std::move(other.m_allocator); // This can throw.
+            swap_storage(other);
+        } else {
+            if (m_allocator != other.m_allocator) {
+                // The nodes keep their indices, so the slots are copied segment by segment.
+                index_t count = segment_count_of(other.m_size);
+                reserve_segments(count);
+                for (index_t i = 0; i < count; i++) {
+                    std::memcpy(m_segments[i], other.m_segments[i], sizeof(np_t) * segment_size);
+                }
+                m_size = other.m_size;
+            } else {
+                swap_storage(other);
+            }
+        }
+        return *this;
+    }
+
+    ~idheap_storage() {
+        release();
+    }
+
+    segmented_slots slots() const noexcept {
+        return segmented_slots{m_segments};
+    }
+
+    static slot_t make_slot(np_t node) noexcept {
+        return node;
+    }
+
+    void reserve(index_t size) {
+        reserve_segments(segment_count_of(size));
+    }
+
+    static constexpr index_t segment_count_of(index_t size) noexcept {
+        return (size + slot_offset + segment_mask) >> SegmentBits;
+    }
+
+    void add_segment() {
+        if (m_segment_count == m_directory_capacity) [[unlikely]] {
+            grow_directory((m_directory_capacity > 0) ? (m_directory_capacity * 2) : 8);
+        }
+        m_segments[m_segment_count] = allocator_traits::allocate(m_allocator, segment_size);
+        m_segment_count++;
+    }
+
+    void reserve_segments(index_t count) {
+        if (count > m_directory_capacity) {
+            grow_directory(std::max<index_t>({count, m_directory_capacity * 2, 8}));
+        }
+        while (m_segment_count < count) {
+            add_segment();
+        }
+    }
+
+    void grow_directory(index_t greater_capacity) {
+        directory_allocator_type alloc{m_allocator};
+        np_t** new_segments = directory_traits::allocate(alloc, greater_capacity);
+        if (m_segments != nullptr) {
+            std::memcpy(new_segments, m_segments, sizeof(np_t*) * m_segment_count);
+            directory_traits::deallocate(alloc, m_segments, m_directory_capacity);
+        }
+        m_segments = new_segments;
+        m_directory_capacity = greater_capacity;
+    }
+
+    void release() noexcept {
+        if (m_segments == nullptr) {
+            return;
+        }
+        for (index_t i = 0; i < m_segment_count; i++) {
+            allocator_traits::deallocate(m_allocator, m_segments[i], segment_size);
+        }
+        directory_allocator_type alloc{m_allocator};
+        directory_traits::deallocate(alloc, m_segments, m_directory_capacity);
+        m_segments = nullptr;
+        m_size = 0;
+        m_segment_count = 0;
+        m_directory_capacity = 0;
+    }
+
+    void swap_storage(idheap_storage& other) noexcept {
+        std::swap(m_segments, other.m_segments);
+        std::swap(m_size, other.m_size);
+        std::swap(m_segment_count, other.m_segment_count);
+        std::swap(m_directory_capacity, other.m_directory_capacity);
+    }
+
+    np_t** m_segments;
+    index_t m_size;
+    index_t m_segment_count;
+    index_t m_directory_capacity;
+    // TODO: Need a macro for msvc.
+    [[no_unique_address]]
+    allocator_type m_allocator;
+};
+
+// Notices:
+// [0] The slot of the index i is i + d - 1 like the segmented storage, the slots are grouped by
+// the arity d in lines. A line is aligned to 64 bytes only if its size is a multiple of 64, such as
+// the arity 4 with 8-byte keys, then the children of a node and their keys are in one cache line
+// and a sift down doesn't load the children. Otherwise the lines are packed, so a slot always takes
+// sizeof(key_slot), which is slot_bytes, and no padding is added.
+// [1] The key in the slot is a copy, after the key of a node is changed, the node must be sifted,
+// which reloads the key, before any other operation.
+template <typename T, typename MT, MT T::* Index, unsigned Arity, typename Allocator, auto Key>
+class idheap_storage<Index, Arity, key_inline<Allocator, Key>> {
+    using np_t = T*;
+    using index_t = MT;
+    using key_t = std::remove_cvref_t<std::invoke_result_t<decltype(Key), const T&>>;
+
+    static_assert(std::is_trivially_copyable_v<key_t>, "The key is copied by memcpy.");
+   public:
+    using slot_t = key_slot<key_t, T>;
+    static constexpr bool fixed_capacity = false;
+    // The bytes of a slot in the storage, the key, the pointer and their padding.
+    static constexpr std::size_t slot_bytes = sizeof(slot_t);
+
+    [[nodiscard]]
+    index_t capacity() const noexcept {
+        return (m_line_count > 0) ? (m_line_count * Arity - slot_offset) : 0;
+    }
+   private:
+    static constexpr std::size_t line_bytes = sizeof(slot_t) * Arity;
+
+    struct alignas((line_bytes % 64 == 0) ? 64 : alignof(slot_t)) line {
+        slot_t slots[Arity];
+    };
+
+    static_assert(sizeof(line) == line_bytes, "The lines must be packed.");
+   public:
+    using allocator_type = std::allocator_traits<Allocator>::template rebind_alloc<line>;
+   protected:
+    using allocator_traits = std::allocator_traits<allocator_type>;
+    static constexpr bool allocator_pocma =
+        allocator_traits::propagate_on_container_move_assignment::value;
+    static constexpr bool allocator_always_equal = allocator_traits::is_always_equal::value;
+    static constexpr index_t slot_offset = Arity - 1;
+    static constexpr unsigned arity_bits = std::countr_zero(Arity);
+
+    struct line_slots {
+        line* lines;
+
+        slot_t* operator()(index_t index) const noexcept {
+            index_t slot = index + slot_offset;
+            return lines[slot >> arity_bits].slots + (slot & (Arity - 1));
+        }
+    };
+
+    explicit idheap_storage(index_t reserve, const allocator_type& alloc)
+        : m_lines{nullptr}
+        , m_size{0}
+        , m_line_count{line_count_of(reserve)}
+        , m_allocator{alloc} {
+        m_lines = allocator_traits::allocate(m_allocator, m_line_count);
+    }
+
+    idheap_storage(idheap_storage&& other) noexcept(
+        std::is_nothrow_move_constructible_v<allocator_type>)
+        : m_lines{other.m_lines}
+        , m_size{other.m_size}
+        , m_line_count{other.m_line_count}
+        , m_allocator(std::move(other.m_allocator)) {
+        other.m_lines = nullptr;
+        other.m_size = 0;
+        other.m_line_count = 0;
+    }
+
+    idheap_storage& operator=(idheap_storage&& other) noexcept(
+        allocator_pocma || allocator_always_equal) {
+        if (this == &other) [[unlikely]] {
+            return *this;
+        }
+        if constexpr (allocator_always_equal) {
+            swap_storage(other);
+        } else if constexpr (allocator_pocma) {
+            release();
+            m_allocator = std::move(other.m_allocator); // This can throw.
+            swap_storage(other);
+        } else {
+            if (m_allocator != other.m_allocator) {
+                index_t count = line_count_of(other.m_size);
+                if (count > m_line_count) {
+                    release();
+                    m_lines = allocator_traits::allocate(m_allocator, other.m_line_count);
+                    m_line_count = other.m_line_count;
+                }
+                std::memcpy(m_lines, other.m_lines, sizeof(line) * count);
+                m_size = other.m_size;
+            } else {
+                swap_storage(other);
+            }
+        }
+        return *this;
+    }
+
+    ~idheap_storage() {
+        release();
+    }
+
+    line_slots slots() const noexcept {
+        return line_slots{m_lines};
+    }
+
+    static slot_t make_slot(np_t node) noexcept {
+        return slot_t{std::invoke(Key, std::as_const(*node)), node};
+    }
+
+    // The lines are doubled at least.
+    void reserve(index_t size) {
+        if (size > capacity()) {
+            expand_lines(std::max<index_t>(m_line_count * 2, line_count_of(size)));
+        }
+    }
+
+    static constexpr index_t line_count_of(index_t capacity) noexcept {
+        return (capacity + slot_offset + (Arity - 1)) >> arity_bits;
+    }
+
+    void expand_lines(index_t greater_count) {
+        line* new_lines = allocator_traits::allocate(m_allocator, greater_count);
+        if (m_lines != nullptr) {
+            std::memcpy(new_lines, m_lines, sizeof(line) * m_line_count);
+            allocator_traits::deallocate(m_allocator, m_lines, m_line_count);
+        }
+        m_lines = new_lines;
+        m_line_count = greater_count;
+    }
+
+    void release() noexcept {
+        if (m_lines != nullptr) {
+            allocator_traits::deallocate(m_allocator, m_lines, m_line_count);
+            m_lines = nullptr;
+        }
+        m_size = 0;
+        m_line_count = 0;
+    }
+
+    void swap_storage(idheap_storage& other) noexcept {
+        std::swap(m_lines, other.m_lines);
+        std::swap(m_size, other.m_size);
+        std::swap(m_line_count, other.m_line_count);
+    }
+
+    line* m_lines;
+    index_t m_size;
+    index_t m_line_count;
+    // TODO: Need a macro for msvc.
+    [[no_unique_address]]
+    allocator_type m_allocator;
+};
+} // namespace detail
+
+// Intrusive Indexed D-ary Heap, the node keeps its index in the pointer array. The arity is 2, 4,
+// 8 or 16, a greater arity makes the tree shallower, so the push is cheaper, and the sift down
+// compares more children per level. The operations are shared by the storages, see
+// detail::idheap_storage.
+template <
+    auto Index,
+    unsigned Arity,
+    typename CMP = std::less<>,
+    typename Allocator = std::allocator<container_t<Index>*>>
+class idheap;
+
+template <typename T, typename MT, MT T::* Index, unsigned Arity, typename CMP, typename Allocator>
+class idheap<Index, Arity, CMP, Allocator> : private detail::idheap_storage<Index, Arity, Allocator> {
+    static_assert(std::is_unsigned_v<MT>, "The index member must be unsigned.");
+
+    using storage_t = detail::idheap_storage<Index, Arity, Allocator>;
+    using np_t = T*;
+    using index_t = MT;
+    using slot_t = storage_t::slot_t;
+    using heap_t = detail::dary_heap<Index, Arity, CMP, slot_t>;
+    static constexpr bool fixed_capacity = storage_t::fixed_capacity;
+
+    using storage_t::m_size;
+    using storage_t::slots;
+    using storage_t::make_slot;
+
+    static constexpr index_t parent_index(index_t index) noexcept {
+        return heap_t::parent_index(index);
+    }
+   public:
+    using allocator_type = storage_t::allocator_type;
+    using storage_t::capacity;
+    using storage_t::slot_bytes;
+
+    explicit idheap(index_t reserve)
+        : storage_t(reserve, allocator_type{}) {
+    }
+
+    explicit idheap(index_t reserve, const allocator_type& alloc)
+        : storage_t(reserve, alloc) {
+    }
+
+    idheap(idheap&& other) = default;
+
+    idheap& operator=(idheap&& other) = default;
+
+    // The slots are referenced by the index of the node，so it's move-only.
+    idheap(const idheap&) = delete;
+
+    idheap& operator=(const idheap&) = delete;
+
+    void push(np_t node) noexcept(fixed_capacity) {
+        // TODO: Process the maximum of index_t
+        if constexpr (!fixed_capacity) {
+            if (m_size == capacity()) [[unlikely]] {
+                storage_t::reserve(m_size + 1);
+            }
+        }
+        heap_t::sift_up(slots(), make_slot(node), m_size);
+        m_size++;
+    }
+
+    // The heap is rebuilt from the batch by Floyd's heapify in linear time.
+    void assign(std::span<const np_t> batch) noexcept(fixed_capacity) {
+        m_size = 0;
+        push_bulk(batch);
+    }
+
+    // The batch is appended and heapified with the nodes in the heap, or pushed one by one if it's
+    // much smaller than the heap.
+    void push_bulk(std::span<const np_t> batch) noexcept(fixed_capacity) {
+        auto count = static_cast<index_t>(batch.size());
+        if constexpr (!fixed_capacity) {
+            storage_t::reserve(m_size + count);
+        }
+        if (heap_t::prefers_heapify(m_size, count)) {
+            for (auto node: batch) {
+                *slots()(m_size) = make_slot(node);
+                node->*Index = m_size;
+                m_size++;
+            }
+            heap_t::heapify(slots(), m_size);
+        } else {
+            for (auto node: batch) {
+                heap_t::sift_up(slots(), make_slot(node), m_size);
+                m_size++;
+            }
+        }
+    }
+
+    [[nodiscard]]
+    T& top() const noexcept {
+        return *heap_t::node_of(*slots()(0));
+    }
+
+    // The key of the top, it's read from the slot.
+    [[nodiscard]]
+    const auto& top_key() const noexcept
+        requires(!std::is_pointer_v<slot_t>)
+    {
+        return slots()(0)->key;
+    }
+
+    [[nodiscard]]
+    bool empty() const noexcept {
+        return m_size == 0;
+    }
+
+    void clear() noexcept {
+        m_size = 0;
+    }
+
+    // The disposer is called on each node in the order of the storage, it may free the node. The
+    // storage is kept for reuse.
+    template <typename Disposer>
+    void clear_and_dispose(Disposer&& disposer) {
+        index_t size = m_size;
+        m_size = 0;
+        for (index_t i = 0; i < size; i++) {
+            disposer(heap_t::node_of(*slots()(i)));
+        }
+    }
+
+    void pop() noexcept {
+        // TODO: UIT_ASSERT(m_size > 0);
+        m_size--;
+        heap_t::sift_down(slots(), m_size, *slots()(m_size), 0);
+    }
+
+    // The top is replaced by the node and sifted down, it's a pop followed by a push in one sift.
+    // The node may be the top itself after its key is changed, such as a periodic timer.
+    void replace_top(np_t node) noexcept {
+        // TODO: UIT_ASSERT(m_size > 0);
+        heap_t::sift_down(slots(), m_size, make_slot(node), 0);
+    }
+
+    // Pushes the node and pops the top, the popped node is returned. If the node isn't greater
+    // than the top, it's returned at once and the heap isn't touched.
+    np_t push_pop(np_t node) noexcept {
+        slot_t cur = make_slot(node);
+        if ((m_size == 0) || !heap_t::less(*slots()(0), cur)) {
+            return node;
+        }
+        np_t top = heap_t::node_of(*slots()(0));
+        heap_t::sift_down(slots(), m_size, cur, 0);
+        return top;
+    }
+
+    void remove(np_t node) noexcept {
+        // TODO: UIT_ASSERT(m_size > 0);
+        m_size--;
+        auto node_idx = node->*Index;
+        if (node_idx < m_size) {
+            slot_t last = *slots()(m_size);
+            if ((node_idx > 0) && heap_t::less(last, *slots()(parent_index(node_idx)))) {
+                heap_t::sift_up(slots(), last, node_idx);
+            } else {
+                heap_t::sift_down(slots(), m_size, last, node_idx);
+            }
+        }
+    }
+
+    // For a min-heap, it's equivalent to the decrease-key operation. The slot of the top is
+    // rewritten, so an inline key is reloaded.
+    void sift_up(np_t node) noexcept {
+        auto node_idx = node->*Index;
+        if (node_idx > 0) {
+            heap_t::sift_up(slots(), make_slot(node), node_idx);
+        } else {
+            *slots()(0) = make_slot(node);
+        }
+    }
+
+    // For a min-heap, it's equivalent to the increase-key operation.
+    void sift_down(np_t node) noexcept {
+        heap_t::sift_down(slots(), m_size, make_slot(node), node->*Index);
+    }
+
+    void sift(np_t node) noexcept {
+        auto node_idx = node->*Index;
+        slot_t cur = make_slot(node);
+        if ((node_idx > 0) && heap_t::less(cur, *slots()(parent_index(node_idx)))) {
+            heap_t::sift_up(slots(), cur, node_idx);
+        } else {
+            heap_t::sift_down(slots(), m_size, cur, node_idx);
+        }
+    }
+
+    [[nodiscard]]
+    index_t size() const noexcept {
+        return m_size;
+    }
+};
+
+namespace pmr {
+template <auto Index, unsigned Arity, typename CMP = std::less<>>
+using idheap =
+    ::uit::idheap<Index, Arity, CMP, std::pmr::polymorphic_allocator<container_t<Index>*>>;
+} // namespace pmr
+
+} // namespace uit
+#endif // idheap.hpp
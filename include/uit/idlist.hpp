@@ -44,6 +44,20 @@ class idlist<Right, Left> {
         m_left = m_right = mock_head();
     }
 
+    // The disposer is called on each node from front to back, it may free the node. The list is
+    // circular, so the walk stops at the mock head.
+    template <typename Disposer>
+    void clear_and_dispose(Disposer &&disposer) {
+        T *mhead = mock_head();
+        T *cur = m_right;
+        clear();
+        while (cur != mhead) {
+            T *next = cur->*Right;
+            disposer(cur);
+            cur = next;
+        }
+    }
+
     [[nodiscard]]
     T &front() const noexcept {
         return *m_right;
@@ -101,6 +115,40 @@ class idlist<Right, Left> {
         return left;
     }
 
+    // Move all nodes of the other list to the front of this list in O(1), the other list must not
+    // be this one and it becomes empty.
+    void splice_front(idlist &other) noexcept {
+        if (other.empty()) [[unlikely]] {
+            return;
+        }
+        T *mhead = mock_head();
+        T *first = other.m_right;
+        T *last = other.m_left;
+
+        last->*Right = m_right;
+        m_right->*Left = last;
+        first->*Left = mhead;
+        m_right = first;
+        other.clear();
+    }
+
+    // Move all nodes of the other list to the back of this list in O(1), the other list must not be
+    // this one and it becomes empty.
+    void splice_back(idlist &other) noexcept {
+        if (other.empty()) [[unlikely]] {
+            return;
+        }
+        T *mhead = mock_head();
+        T *first = other.m_right;
+        T *last = other.m_left;
+
+        m_left->*Right = first;
+        first->*Left = m_left;
+        last->*Right = mhead;
+        m_left = last;
+        other.clear();
+    }
+
     template <typename T_CV, bool is_reverse = false>
     struct iterator_t {
         using iterator_category = std::bidirectional_iterator_tag;
@@ -52,6 +52,18 @@ class idslist<Right> {
         m_left = mock_head();
     }
 
+    // The disposer is called on each node from front to back, it may free the node.
+    template <typename Disposer>
+    void clear_and_dispose(Disposer &&disposer) {
+        T *cur = m_right;
+        clear();
+        while (cur != nullptr) {
+            T *next = cur->*Right;
+            disposer(cur);
+            cur = next;
+        }
+    }
+
     [[nodiscard]]
     T &front() const noexcept {
         return *m_right;
@@ -108,6 +120,31 @@ class idslist<Right> {
         return nullptr;
     }
 
+    // Move all nodes of the other list to the front of this list in O(1), the other list must not
+    // be this one and it becomes empty.
+    void splice_front(idslist &other) noexcept {
+        if (other.empty()) [[unlikely]] {
+            return;
+        }
+        if (m_right == nullptr) {
+            m_left = other.m_left;
+        }
+        other.m_left->*Right = m_right;
+        m_right = other.m_right;
+        other.clear();
+    }
+
+    // Move all nodes of the other list to the back of this list in O(1), the other list must not be
+    // this one and it becomes empty.
+    void splice_back(idslist &other) noexcept {
+        if (other.empty()) [[unlikely]] {
+            return;
+        }
+        m_left->*Right = other.m_right;
+        m_left = other.m_left;
+        other.clear();
+    }
+
     template <typename T_CV>
     struct iterator_t {
         using iterator_category = std::forward_iterator_tag;
@@ -5,6 +5,8 @@
 #ifndef UIT_INTRUSIVE_F553190D_A9E1_4D56_9310_9CE4208E5ADD
 #define UIT_INTRUSIVE_F553190D_A9E1_4D56_9310_9CE4208E5ADD
 #include <cstddef>
+#include <functional>
+#include <type_traits>
 
 namespace uit {
 
@@ -55,5 +57,34 @@ const T *const_container_of(M T::*field, const M *m) noexcept {
 template <typename T>
 concept has_is_transparent = requires { typename T::is_transparent; };
 
+// Equivalent nodes are ordered by their addresses, so nodes of a multiset become unique, and a
+// node can be found or removed by itself in O(log n). Keys of other types are compared by CMP only,
+// so a lookup by such a key finds any one of the equivalent nodes.
+template <typename CMP = std::less<>>
+struct address_tiebreak {
+    using is_transparent = void;
+
+    template <typename T>
+    bool operator()(const T &a, const T &b) const noexcept {
+        if (cmp(a, b)) {
+            return true;
+        }
+        if (cmp(b, a)) {
+            return false;
+        }
+        return std::less<const T *>{}(&a, &b);
+    }
+
+    template <typename A, typename B>
+        requires(!std::is_same_v<A, B>)
+    bool operator()(const A &a, const B &b) const noexcept {
+        return cmp(a, b);
+    }
+
+    // TODO: need a macro for the msvc.
+    [[no_unique_address]]
+    CMP cmp;
+};
+
 } // namespace uit
 #endif // intrusive.hpp
\ No newline at end of file
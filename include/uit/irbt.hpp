@@ -0,0 +1,472 @@
+// SPDX-FileCopyrightText: 2025 TypeCombinator <typecombinator@foxmail.com>
+//
+// SPDX-License-Identifier: BSD 3-Clause
+
+#ifndef UIT_IRBT_5C0E5A41_7B7D_4B8E_9E0A_3D6C2F1B8A94
+#define UIT_IRBT_5C0E5A41_7B7D_4B8E_9E0A_3D6C2F1B8A94
+#include <uit/intrusive.hpp>
+#include <uit/detail/comparator.hpp>
+#include <cstddef>
+#include <functional>
+
+// References:
+// [0] Thomas H. Cormen, et al. Introduction to Algorithms, Chapter 13: Red-Black Trees.
+// [1] Linux kernel, lib/rbtree.c.
+// Notices:
+// [0] The acronym irbt stands for intrusive red-black tree.
+// [1] The mock sentinel will involve UB, but the code works correctly.
+// [2] Nodes have parent pointers, the parent of the root is the mock sentinel, just like the nil of
+// CLRS. Unlike CLRS, the sentinel is never written, the parent of a removed position is tracked
+// separately, as what Linux does.
+namespace uit {
+template <auto Right, auto Left, auto Parent, auto Color, typename CMP = std::less<>>
+struct irbt;
+
+template <
+    typename T,
+    typename MT,
+    MT T::*Right,
+    MT T::*Left,
+    MT T::*Parent,
+    auto Color,
+    typename CMP>
+struct irbt<Right, Left, Parent, Color, CMP> {
+   public:
+    using np_t = T *;
+    using cnp_t = const T *;
+    using color_t = uit::member_t<Color>;
+
+    static constexpr color_t red{0};
+    static constexpr color_t black{1};
+
+    irbt() noexcept
+        : m_head{mock_sentinel()}
+        , m_size{0} {
+    }
+
+    [[nodiscard]]
+    static bool is_sentinel(const T *node) noexcept {
+        return node == const_mock_sentinel();
+    }
+
+    [[nodiscard]]
+    bool empty() const noexcept {
+        return is_sentinel(m_head);
+    }
+
+    void clear() noexcept {
+        m_head = mock_sentinel();
+        m_size = 0;
+    }
+
+    // The disposer is called on each node in order, it may free the node. Parent pointers aren't
+    // needed: the left child is rotated up until there is none, then the node is disposed and the
+    // walk goes right, just like boost.intrusive.
+    template <typename Disposer>
+    void clear_and_dispose(Disposer &&disposer) {
+        np_t cur = m_head;
+        clear();
+        while (!is_sentinel(cur)) {
+            np_t left = cur->*Left;
+            if (!is_sentinel(left)) {
+                cur->*Left = left->*Right;
+                left->*Right = cur;
+                cur = left;
+            } else {
+                np_t right = cur->*Right;
+                disposer(cur);
+                cur = right;
+            }
+        }
+    }
+
+    [[nodiscard]]
+    std::size_t size() const noexcept {
+        return m_size;
+    }
+
+    void insert_multi(np_t node) noexcept {
+        np_t parent = mock_sentinel();
+        np_t *cur_ptr = &m_head;
+        np_t cur = m_head;
+        while (!is_sentinel(cur)) {
+            parent = cur;
+            if (cmp(*node, *cur)) {
+                cur_ptr = &(cur->*Left);
+            } else {
+                cur_ptr = &(cur->*Right);
+            }
+            cur = *cur_ptr;
+        }
+        insert_leaf(*cur_ptr, parent, node);
+        insert_fixup(node);
+        m_size++;
+    }
+
+    // insert unique
+    bool insert(np_t node) noexcept {
+        np_t parent = mock_sentinel();
+        np_t *cur_ptr = &m_head;
+        np_t cur = m_head;
+        while (!is_sentinel(cur)) {
+            parent = cur;
+            auto order = cmp.compare(*node, *cur);
+            if (order < 0) {
+                cur_ptr = &(cur->*Left);
+            } else if (order > 0) {
+                cur_ptr = &(cur->*Right);
+            } else {
+                return false;
+            }
+            cur = *cur_ptr;
+        }
+        insert_leaf(*cur_ptr, parent, node);
+        insert_fixup(node);
+        m_size++;
+        return true;
+    }
+
+    // The node must be in this tree, it's removed by its parent pointers without a lookup, just
+    // like rb_erase of Linux, and the rebalancing is O(1) amortized.
+    void erase(np_t node) noexcept {
+        np_t child;
+        np_t parent;
+        color_t removed_color = node->*Color;
+
+        if (is_sentinel(node->*Left)) {
+            child = node->*Right;
+            parent = node->*Parent;
+            transplant(node, child);
+        } else if (is_sentinel(node->*Right)) {
+            child = node->*Left;
+            parent = node->*Parent;
+            transplant(node, child);
+        } else {
+            np_t successor = leftmost(node->*Right);
+            removed_color = successor->*Color;
+            child = successor->*Right;
+            if (successor->*Parent == node) {
+                parent = successor;
+            } else {
+                parent = successor->*Parent;
+                transplant(successor, child);
+                successor->*Right = node->*Right;
+                successor->*Right->*Parent = successor;
+            }
+            transplant(node, successor);
+            successor->*Left = node->*Left;
+            successor->*Left->*Parent = successor;
+            successor->*Color = node->*Color;
+        }
+        if (removed_color == black) {
+            erase_fixup(child, parent);
+        }
+        m_size--;
+    }
+
+    // The checked variant of erase, it returns false if the node isn't in this tree, such as a node
+    // that was erased or belongs to another tree. The parent pointers alone can't tell that, since
+    // such a node may have stale ones, so the node is looked up by its key, then the equivalent
+    // nodes are walked in order until the node is met, it's O(log n + d), where d is the number of
+    // equivalent nodes.
+    bool checked_erase(np_t node) noexcept {
+        np_t cur = m_head;
+        np_t first = mock_sentinel(); // The first node that isn't less than the node.
+        while (!is_sentinel(cur)) {
+            if (cmp(*cur, *node)) {
+                cur = cur->*Right;
+            } else {
+                first = cur;
+                cur = cur->*Left;
+            }
+        }
+        for (cur = first; !is_sentinel(cur) && !cmp(*node, *cur); cur = next(cur)) {
+            if (cur == node) {
+                erase(node);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // It's UB when the tree is empty, so you must check for emptiness before calling this function.
+    np_t remove_leftmost() noexcept {
+        np_t node = leftmost(m_head);
+        erase(node);
+        return node;
+    }
+
+    template <typename K>
+    np_t remove(const K &key) noexcept {
+        np_t node = find(key);
+        if (node != nullptr) {
+            erase(node);
+        }
+        return node;
+    }
+
+    template <typename K>
+    [[nodiscard]]
+    np_t find(const K &key) const noexcept {
+        cnp_t cur = m_head;
+        while (!is_sentinel(cur)) {
+            auto order = cmp.compare(key, *cur);
+            if (order < 0) {
+                cur = cur->*Left;
+            } else if (order > 0) {
+                cur = cur->*Right;
+            } else {
+                return const_cast<np_t>(cur);
+            }
+        }
+        return nullptr;
+    }
+
+    [[nodiscard]]
+    std::size_t height() const noexcept {
+        return height_impl(m_head);
+    }
+
+    static bool validate_sentinel() noexcept {
+        auto s = const_mock_sentinel();
+        return (s->*Right == s) && (s->*Left == s) && (s->*Parent == s) && (s->*Color == black);
+    }
+   private:
+    [[nodiscard]]
+    static bool is_red(const T *node) noexcept {
+        // The color of the sentinel is always black.
+        return node->*Color == red;
+    }
+
+    static np_t leftmost(np_t cur) noexcept {
+        while (!is_sentinel(cur->*Left)) {
+            cur = cur->*Left;
+        }
+        return cur;
+    }
+
+    // Returns the next node in order, or the sentinel after the rightmost.
+    static np_t next(np_t cur) noexcept {
+        if (!is_sentinel(cur->*Right)) {
+            return leftmost(cur->*Right);
+        }
+        np_t parent = cur->*Parent;
+        while (!is_sentinel(parent) && (parent->*Right == cur)) {
+            cur = parent;
+            parent = cur->*Parent;
+        }
+        return parent;
+    }
+
+    np_t &child_ref(np_t parent, np_t child) noexcept {
+        if (is_sentinel(parent)) {
+            return m_head;
+        }
+        return (parent->*Left == child) ? parent->*Left : parent->*Right;
+    }
+
+    // Replace the subtree rooted at "u" with the subtree rooted at "v".
+    void transplant(np_t u, np_t v) noexcept {
+        np_t parent = u->*Parent;
+        child_ref(parent, u) = v;
+        if (!is_sentinel(v)) {
+            v->*Parent = parent;
+        }
+    }
+
+    void left_rotate(np_t n) noexcept {
+        np_t s = n->*Right;
+        np_t sl = s->*Left;
+
+        n->*Right = sl;
+        if (!is_sentinel(sl)) {
+            sl->*Parent = n;
+        }
+        np_t parent = n->*Parent;
+        s->*Parent = parent;
+        child_ref(parent, n) = s;
+        s->*Left = n;
+        n->*Parent = s;
+    }
+
+    void right_rotate(np_t n) noexcept {
+        np_t s = n->*Left;
+        np_t sr = s->*Right;
+
+        n->*Left = sr;
+        if (!is_sentinel(sr)) {
+            sr->*Parent = n;
+        }
+        np_t parent = n->*Parent;
+        s->*Parent = parent;
+        child_ref(parent, n) = s;
+        s->*Right = n;
+        n->*Parent = s;
+    }
+
+    void insert_fixup(np_t node) noexcept {
+        np_t parent = node->*Parent;
+        // The parent of the root is the sentinel, and it's black, so no extra check is required.
+        while (is_red(parent)) {
+            // A red node is never the root, so the grandparent is always a real node.
+            np_t gparent = parent->*Parent;
+            if (parent == gparent->*Left) {
+                np_t uncle = gparent->*Right;
+                if (is_red(uncle)) {
+                    parent->*Color = black;
+                    uncle->*Color = black;
+                    gparent->*Color = red;
+                    node = gparent;
+                    parent = node->*Parent;
+                    continue;
+                }
+                if (node == parent->*Right) {
+                    left_rotate(parent);
+                    parent = node;
+                }
+                parent->*Color = black;
+                gparent->*Color = red;
+                right_rotate(gparent);
+                break;
+            } else {
+                np_t uncle = gparent->*Left;
+                if (is_red(uncle)) {
+                    parent->*Color = black;
+                    uncle->*Color = black;
+                    gparent->*Color = red;
+                    node = gparent;
+                    parent = node->*Parent;
+                    continue;
+                }
+                if (node == parent->*Left) {
+                    right_rotate(parent);
+                    parent = node;
+                }
+                parent->*Color = black;
+                gparent->*Color = red;
+                left_rotate(gparent);
+                break;
+            }
+        }
+        m_head->*Color = black;
+    }
+
+    // The "node" may be the sentinel, so its parent is passed in separately.
+    void erase_fixup(np_t node, np_t parent) noexcept {
+        while ((node != m_head) && !is_red(node)) {
+            // The sibling of a doubly black node is never the sentinel, so "parent->*Left == node"
+            // is unambiguous even if the node is the sentinel.
+            if (node == parent->*Left) {
+                np_t sibling = parent->*Right;
+                if (is_red(sibling)) {
+                    sibling->*Color = black;
+                    parent->*Color = red;
+                    left_rotate(parent);
+                    sibling = parent->*Right;
+                }
+                if (!is_red(sibling->*Left) && !is_red(sibling->*Right)) {
+                    sibling->*Color = red;
+                    node = parent;
+                    parent = node->*Parent;
+                } else {
+                    if (!is_red(sibling->*Right)) {
+                        sibling->*Left->*Color = black;
+                        sibling->*Color = red;
+                        right_rotate(sibling);
+                        sibling = parent->*Right;
+                    }
+                    sibling->*Color = parent->*Color;
+                    parent->*Color = black;
+                    sibling->*Right->*Color = black;
+                    left_rotate(parent);
+                    node = m_head;
+                    break;
+                }
+            } else {
+                np_t sibling = parent->*Left;
+                if (is_red(sibling)) {
+                    sibling->*Color = black;
+                    parent->*Color = red;
+                    right_rotate(parent);
+                    sibling = parent->*Left;
+                }
+                if (!is_red(sibling->*Right) && !is_red(sibling->*Left)) {
+                    sibling->*Color = red;
+                    node = parent;
+                    parent = node->*Parent;
+                } else {
+                    if (!is_red(sibling->*Left)) {
+                        sibling->*Right->*Color = black;
+                        sibling->*Color = red;
+                        left_rotate(sibling);
+                        sibling = parent->*Left;
+                    }
+                    sibling->*Color = parent->*Color;
+                    parent->*Color = black;
+                    sibling->*Left->*Color = black;
+                    right_rotate(parent);
+                    node = m_head;
+                    break;
+                }
+            }
+        }
+        if (!is_sentinel(node)) {
+            node->*Color = black;
+        }
+    }
+
+    static void insert_leaf(np_t &cur, np_t parent, np_t node) noexcept {
+        cur = node;
+        node->*Right = mock_sentinel();
+        node->*Left = mock_sentinel();
+        node->*Parent = parent;
+        node->*Color = red;
+    }
+
+    [[nodiscard]]
+    static std::size_t height_impl(const T *root) noexcept {
+        if (is_sentinel(root)) {
+            return 0;
+        }
+        std::size_t left_height = height_impl(root->*Left);
+        std::size_t right_height = height_impl(root->*Right);
+        return (left_height > right_height ? left_height : right_height) + 1;
+    }
+
+    union sentinel_t {
+        constexpr sentinel_t() noexcept {
+            // UB!!! The lifetime of storage has not yet started.
+            storage.*Right = &storage;
+            storage.*Left = &storage;
+            storage.*Parent = &storage;
+            storage.*Color = black;
+        }
+
+        // The storage is never constructed, so it must not be destroyed, T may have non-trivial
+        // members such as std::string.
+        constexpr ~sentinel_t() {
+        }
+
+        T storage;
+        unsigned char buffer[sizeof(T)];
+    };
+
+    // It's a fixed point!
+    static inline const sentinel_t sentinel{};
+
+    static T *mock_sentinel() noexcept {
+        return const_cast<T *>(&sentinel.storage);
+    }
+
+    static const T *const_mock_sentinel() noexcept {
+        return &sentinel.storage;
+    }
+
+    // TODO: need a macro for the msvc.
+    [[no_unique_address]]
+    detail::comparator<CMP> cmp;
+    T *m_head;
+    std::size_t m_size;
+};
+} // namespace uit
+#endif // irbt.hpp
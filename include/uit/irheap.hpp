@@ -5,6 +5,7 @@
 #ifndef UIT_IRHEAP_001A9AE4_0EE4_4CF6_9871_6AE428316DD7
 #define UIT_IRHEAP_001A9AE4_0EE4_4CF6_9871_6AE428316DD7
 #include <functional>
+#include <span>
 #include <uit/bit.hpp>
 
 namespace uit {
@@ -84,6 +85,44 @@ class irheap<Right, Left, CMP> {
         node->*Left = nullptr;
     }
 
+    // The heap is rebuilt from the batch in linear time: the batch is linked into a complete tree in
+    // the order of the levels, the node k has the children 2k and 2k + 1, then the parents are
+    // sifted down from the last one to the root, that's Floyd's heapify.
+    void assign(std::span<const np_t> batch) noexcept {
+        m_size = batch.size();
+        if (m_size == 0) {
+            m_head = nullptr;
+            return;
+        }
+        for (m_size_t k = 1; k <= m_size; k++) {
+            np_t node = batch[k - 1];
+            node->*Left = (2 * k <= m_size) ? batch[2 * k - 1] : nullptr;
+            node->*Right = (2 * k + 1 <= m_size) ? batch[2 * k] : nullptr;
+        }
+        m_head = batch[0];
+        // The parent of the node k hasn't been sifted yet, so it's still in its place.
+        for (m_size_t k = m_size / 2; k > 0; k--) {
+            np_t *cur_ptr = &m_head;
+            if (k > 1) {
+                np_t parent = batch[k / 2 - 1];
+                cur_ptr = (k & 1u) ? &(parent->*Right) : &(parent->*Left);
+            }
+            sift_down(batch[k - 1], cur_ptr);
+        }
+    }
+
+    // The existing nodes aren't in an array, so the batch is heapified only if the heap is empty,
+    // otherwise it's pushed one by one.
+    void push_bulk(std::span<const np_t> batch) noexcept {
+        if (m_size == 0) {
+            assign(batch);
+            return;
+        }
+        for (auto node: batch) {
+            push(node);
+        }
+    }
+
     void pop() noexcept {
         if (m_size <= 1u) [[unlikely]] {
             m_head = nullptr;
@@ -100,6 +139,30 @@ class irheap<Right, Left, CMP> {
         sift_down(m_head, &m_head);
     }
 
+    // The top is replaced by the node and sifted down, so the last leaf isn't walked to, and the
+    // insertion path isn't taken. The node may be the top itself after its key is changed, such
+    // as a periodic timer.
+    void replace_top(np_t node) noexcept {
+        // TODO: UIT_ASSERT(m_size > 0);
+        if (node != m_head) {
+            node->*Right = m_head->*Right;
+            node->*Left = m_head->*Left;
+            m_head = node;
+        }
+        sift_down(m_head, &m_head);
+    }
+
+    // Pushes the node and pops the top, the popped node is returned. If the node isn't greater
+    // than the top, it's returned at once and the heap isn't touched.
+    np_t push_pop(np_t node) noexcept {
+        if ((m_head == nullptr) || !CMP{}(*m_head, *node)) {
+            return node;
+        }
+        np_t top = m_head;
+        replace_top(node);
+        return top;
+    }
+
     [[nodiscard]]
     T &top() const noexcept {
         return *m_head;
@@ -118,6 +181,27 @@ class irheap<Right, Left, CMP> {
     void clear() noexcept {
         *this = {};
     }
+
+    // The disposer is called on each node once, it may free the node. The left child is rotated up
+    // until there is none, then the node is disposed and the walk goes right, so no stack is
+    // required, see boost.intrusive.
+    template <typename Disposer>
+    void clear_and_dispose(Disposer &&disposer) {
+        np_t cur = m_head;
+        clear();
+        while (cur != nullptr) {
+            np_t left = cur->*Left;
+            if (left != nullptr) {
+                cur->*Left = left->*Right;
+                left->*Right = cur;
+                cur = left;
+            } else {
+                np_t right = cur->*Right;
+                disposer(cur);
+                cur = right;
+            }
+        }
+    }
    private:
     static inline void swap_with_right_child(np_t cur, np_t child) noexcept {
         cur->*Right = child->*Right;
@@ -5,7 +5,14 @@
 #ifndef UIT_IRSBT_863421E6_3490_4C93_AD0F_0645A51AA38F
 #define UIT_IRSBT_863421E6_3490_4C93_AD0F_0645A51AA38F
 #include <uit/intrusive.hpp>
+#include <uit/detail/comparator.hpp>
+#include <uit/detail/radix_sort.hpp>
+#include <uit/wbt_balance.hpp>
+#include <algorithm>
+#include <concepts>
 #include <functional>
+#include <span>
+#include <utility>
 
 // References:
 // [0] Chen Qifeng. Size Balanced Tree. 2006.
@@ -19,13 +26,26 @@
 // in irwbt.hpp.
 namespace uit {
 // struct [[deprecated]] irsbt;
-template <auto Right, auto Left, auto Size, typename CMP = std::less<>>
+template <
+    auto Right,
+    auto Left,
+    auto Size,
+    typename CMP = std::less<>,
+    typename Balance = wbt_balance<>>
 struct irsbt;
 
-template <typename T, typename MT, MT T::*Right, MT T::*Left, auto Size, typename CMP>
-struct irsbt<Right, Left, Size, CMP> {
+template <
+    typename T,
+    typename MT,
+    MT T::*Right,
+    MT T::*Left,
+    auto Size,
+    typename CMP,
+    typename Balance>
+struct irsbt<Right, Left, Size, CMP, Balance> {
    public:
     using np_t = T *;
+    using nsize_t = uit::member_t<Size>;
 
     irsbt() noexcept {
         head = mock_sentinel();
@@ -45,6 +65,27 @@ struct irsbt<Right, Left, Size, CMP> {
         head = mock_sentinel();
     }
 
+    // The disposer is called on each node in order, it may free the node. The left child is rotated
+    // up until there is none, then the node is disposed and the walk goes right, so it's O(n) time
+    // and O(1) space, see boost.intrusive.
+    template <typename Disposer>
+    void clear_and_dispose(Disposer &&disposer) {
+        np_t cur = head;
+        clear();
+        while (!is_sentinel(cur)) {
+            np_t left = cur->*Left;
+            if (!is_sentinel(left)) {
+                cur->*Left = left->*Right;
+                left->*Right = cur;
+                cur = left;
+            } else {
+                np_t right = cur->*Right;
+                disposer(cur);
+                cur = right;
+            }
+        }
+    }
+
     [[nodiscard]]
     std::size_t size() const noexcept {
         return head->*Size;
@@ -66,6 +107,42 @@ struct irsbt<Right, Left, Size, CMP> {
         winsert_multi_impl(head, node);
     }
 
+    // The node must not be less than any node in the tree, so no comparison is required.
+    void push_back_max(np_t node) noexcept {
+        push_back_max_impl(head, node);
+    }
+
+    // The hint must be the rightmost node, or nullptr if the tree is empty, it's trusted and not
+    // checked, since back() walks the right spine. Nodes don't have parent pointers, so the hint
+    // is only used as the maximum: if the new node isn't less than it, the node is pushed back
+    // without comparisons, otherwise it's equivalent to insert_multi. For a near-monotonic stream,
+    // the caller keeps the maximum of the inserted nodes as the hint.
+    void insert_hint(np_t hint, np_t node) noexcept {
+        if ((hint != nullptr) && !cmp(*node, *hint)) {
+            push_back_max_impl(head, node);
+        } else {
+            insert_multi_impl(head, node);
+        }
+    }
+
+    // Insert a batch of nodes, the batch is sorted in place. The batch is merged into the tree in
+    // one traversal: it's partitioned once at the root of each touched subtree, and each touched
+    // subtree is rebalanced once on the way back. A subtree that isn't larger than its part of the
+    // batch is merged with it into a list and rebuilt in linear time.
+    void insert_batch(std::span<np_t> batch) noexcept {
+        std::sort(batch.begin(), batch.end(), [this](np_t a, np_t b) { return cmp(*a, *b); });
+        insert_sorted_batch(batch.data(), batch.data() + batch.size());
+    }
+
+    // The same as above, but the batch is sorted by a radix sort on the integral key, so the order
+    // of the key must be the same as the order of CMP.
+    template <auto Key>
+        requires std::integral<uit::member_t<Key>> && std::same_as<uit::container_t<Key>, T>
+    void insert_batch(std::span<np_t> batch) {
+        detail::radix_sort<Key>(batch.data(), batch.data() + batch.size());
+        insert_sorted_batch(batch.data(), batch.data() + batch.size());
+    }
+
     np_t remove_unique(const T &node) noexcept {
         // Remove without balance!
         return remove_unique_impl(head, node);
@@ -77,6 +154,64 @@ struct irsbt<Right, Left, Size, CMP> {
         return remove_unique_impl(head, k);
     }
 
+    // Remove exactly the node, even if there are other equivalent nodes, without balance. It's
+    // O(log n + d), where d is the number of equivalent nodes, and O(log n) with the
+    // address_tiebreak comparator. Returns false if the node isn't in the tree.
+    bool erase(np_t node) noexcept {
+        if constexpr (is_template_instance_of_v<CMP, address_tiebreak>) {
+            return remove_unique_impl(head, *node) != nullptr;
+        } else {
+            return erase_impl(head, node);
+        }
+    }
+
+    // It's UB when the tree is empty, so you must check for emptiness before calling this function.
+    np_t remove_leftmost() noexcept {
+        np_t next;
+        return remove_leftmost(next);
+    }
+
+    // The same as above, and the new leftmost node is stored to "next", or nullptr if the tree
+    // becomes empty. Remove without balance, just like remove_unique.
+    np_t remove_leftmost(np_t &next) noexcept {
+        np_t *cur_ptr = &head;
+        np_t cur = head;
+        np_t parent = nullptr;
+
+        while (!is_sentinel(cur->*Left)) {
+            (cur->*Size)--;
+            parent = cur;
+            cur_ptr = &(cur->*Left);
+            cur = *cur_ptr;
+        }
+        *cur_ptr = cur->*Right;
+        next = is_sentinel(cur->*Right) ? parent : leftmost(cur->*Right);
+        return cur;
+    }
+
+    // It's UB when the tree is empty, so you must check for emptiness before calling this function.
+    np_t remove_rightmost() noexcept {
+        np_t prev;
+        return remove_rightmost(prev);
+    }
+
+    // The mirror of remove_leftmost, the new rightmost node is stored to "prev".
+    np_t remove_rightmost(np_t &prev) noexcept {
+        np_t *cur_ptr = &head;
+        np_t cur = head;
+        np_t parent = nullptr;
+
+        while (!is_sentinel(cur->*Right)) {
+            (cur->*Size)--;
+            parent = cur;
+            cur_ptr = &(cur->*Right);
+            cur = *cur_ptr;
+        }
+        *cur_ptr = cur->*Left;
+        prev = is_sentinel(cur->*Left) ? parent : rightmost(cur->*Left);
+        return cur;
+    }
+
     [[nodiscard]]
     np_t find(const T &node) const noexcept {
         return find_impl(head, node);
@@ -89,6 +224,32 @@ struct irsbt<Right, Left, Size, CMP> {
         return find_impl(head, k);
     }
 
+    // Returns the first node that is not less than the node, or nullptr if there is no such node.
+    [[nodiscard]]
+    np_t lower_bound(const T &node) const noexcept {
+        return lower_bound_impl(head, node);
+    }
+
+    template <typename K>
+        requires has_is_transparent<CMP>
+    [[nodiscard]]
+    np_t lower_bound(const K &k) const noexcept {
+        return lower_bound_impl(head, k);
+    }
+
+    // In-order traversal.
+    template <typename F>
+    void for_each(F &&f) const {
+        for_each_impl(head, f);
+    }
+
+    // In-order traversal of the nodes whose ranks are in [first, last), it requires
+    // first <= last <= size(), see parallel_for_each.
+    template <typename F>
+    void for_each_range(std::size_t first, std::size_t last, F &&f) const {
+        for_each_range_impl(head, first, last, f);
+    }
+
     [[nodiscard]]
     np_t at(std::size_t pos) const noexcept {
         np_t root = head;
@@ -120,6 +281,19 @@ struct irsbt<Right, Left, Size, CMP> {
         return position_impl(head, k);
     }
 
+    // Returns the leftmost node, or nullptr if the tree is empty. It's O(log n), see irsbt_cached
+    // for O(1).
+    [[nodiscard]]
+    np_t front() const noexcept {
+        return empty() ? nullptr : leftmost(head);
+    }
+
+    // Returns the rightmost node, or nullptr if the tree is empty.
+    [[nodiscard]]
+    np_t back() const noexcept {
+        return empty() ? nullptr : rightmost(head);
+    }
+
     [[nodiscard]]
     std::size_t height() const noexcept {
         return height_impl(head);
@@ -184,18 +358,18 @@ struct irsbt<Right, Left, Size, CMP> {
         maintain(root, false);
     }
 
-    template <auto DELTA = 3, auto GAMMA = 3>
+    // The weight-balanced maintain of the winsert functions, see wbt_balance.
     static void wmaintain(np_t &root, bool right_leaning) noexcept {
         if (right_leaning) {
-            if ((root->*Left->*Size * DELTA + 1) < (root->*Right->*Size)) {
-                if (root->*Right->*Right->*Size * GAMMA < root->*Right->*Size) {
+            if (Balance::is_heavy(root->*Left->*Size, root->*Right->*Size)) {
+                if (Balance::is_double(root->*Right->*Left->*Size, root->*Right->*Right->*Size)) {
                     right_rotate(root->*Right);
                 }
                 left_rotate(root);
             }
         } else {
-            if ((root->*Right->*Size * DELTA + 1) < root->*Left->*Size) {
-                if (root->*Left->*Left->*Size * GAMMA < root->*Left->*Size) {
+            if (Balance::is_heavy(root->*Right->*Size, root->*Left->*Size)) {
+                if (Balance::is_double(root->*Left->*Right->*Size, root->*Left->*Left->*Size)) {
                     left_rotate(root->*Left);
                 }
                 right_rotate(root);
@@ -212,14 +386,15 @@ struct irsbt<Right, Left, Size, CMP> {
             root = node;
             return nullptr;
         }
-        if (cmp(*node, *root)) {
+        auto order = cmp.compare(*node, *root);
+        if (order < 0) {
             node = insert_unique_impl(root->*Left, node);
             if (node == nullptr) {
                 (root->*Size)++;
                 maintain(root, false);
             }
             return node;
-        } else if (cmp(*root, *node)) {
+        } else if (order > 0) {
             node = insert_unique_impl(root->*Right, node);
             if (node == nullptr) {
                 (root->*Size)++;
@@ -241,14 +416,15 @@ struct irsbt<Right, Left, Size, CMP> {
             root = node;
             return nullptr;
         }
-        if (cmp(*node, *root)) {
+        auto order = cmp.compare(*node, *root);
+        if (order < 0) {
             node = winsert_unique_impl(root->*Left, node);
             if (node == nullptr) {
                 (root->*Size)++;
                 wmaintain(root, false);
             }
             return node;
-        } else if (cmp(*root, *node)) {
+        } else if (order > 0) {
             node = winsert_unique_impl(root->*Right, node);
             if (node == nullptr) {
                 (root->*Size)++;
@@ -279,6 +455,132 @@ struct irsbt<Right, Left, Size, CMP> {
         }
     }
 
+    static void push_back_max_impl(np_t &root, np_t node) noexcept {
+        if (is_sentinel(root)) [[unlikely]] {
+            node->*Right = mock_sentinel();
+            node->*Left = mock_sentinel();
+            node->*Size = 1;
+
+            root = node;
+            return;
+        }
+        (root->*Size)++;
+        push_back_max_impl(root->*Right, node);
+        maintain(root, true);
+    }
+
+    // The root must not be the sentinel.
+    static np_t leftmost(np_t root) noexcept {
+        while (!is_sentinel(root->*Left)) {
+            root = root->*Left;
+        }
+        return root;
+    }
+
+    static np_t rightmost(np_t root) noexcept {
+        while (!is_sentinel(root->*Right)) {
+            root = root->*Right;
+        }
+        return root;
+    }
+
+    void insert_sorted_batch(np_t *first, np_t *last) noexcept {
+        insert_batch_impl(head, first, last);
+    }
+
+    void insert_batch_impl(np_t &root, np_t *first, np_t *last) noexcept {
+        if (first == last) {
+            return;
+        }
+        std::size_t k = static_cast<std::size_t>(last - first);
+        if (k == 1) {
+            insert_multi_impl(root, *first);
+            return;
+        }
+        std::size_t n = root->*Size;
+        // It's cheaper to rebuild the subtree when the batch isn't smaller than it, and the empty
+        // subtree is handled by the way.
+        if (k >= n) {
+            np_t list = merge_to_list(flatten(root, mock_sentinel()), first, last);
+            root = build_from_list(list, n + k);
+            return;
+        }
+        // Equivalent nodes go right, just like insert_multi.
+        np_t *mid = std::partition_point(
+            first, last, [this, root](np_t node) { return cmp(*node, *root); });
+        insert_batch_impl(root->*Left, first, mid);
+        insert_batch_impl(root->*Right, mid, last);
+        root->*Size += static_cast<nsize_t>(k);
+        rebalance(root);
+    }
+
+    [[nodiscard]]
+    static bool is_balanced(const T *root) noexcept {
+        const T *left = root->*Left;
+        const T *right = root->*Right;
+        return (left->*Size >= right->*Left->*Size) && (left->*Size >= right->*Right->*Size)
+            && (right->*Size >= left->*Left->*Size) && (right->*Size >= left->*Right->*Size);
+    }
+
+    // The children are balanced. The maintain is enough for a slight imbalance, otherwise the
+    // subtree is rebuilt.
+    static void rebalance(np_t &root) noexcept {
+        if (is_balanced(root)) [[likely]] {
+            return;
+        }
+        maintain(root, root->*Left->*Size < root->*Right->*Size);
+        if (is_balanced(root) && is_balanced(root->*Left) && is_balanced(root->*Right)) {
+            return;
+        }
+        std::size_t n = root->*Size;
+        np_t list = flatten(root, mock_sentinel());
+        root = build_from_list(list, n);
+    }
+    // Flatten the subtree into a list linked by the right child in order, and append the tail.
+    static np_t flatten(np_t root, np_t tail) noexcept {
+        while (!is_sentinel(root)) {
+            root->*Right = flatten(root->*Right, tail);
+            tail = root;
+            root = root->*Left;
+        }
+        return tail;
+    }
+
+    // Merge a sorted array into a sorted list, equivalent nodes of the array go after the list.
+    np_t merge_to_list(np_t list, np_t *first, np_t *last) noexcept {
+        np_t merged = mock_sentinel();
+        np_t *tail = &merged;
+        while (!is_sentinel(list) && (first != last)) {
+            if (cmp(**first, *list)) {
+                *tail = *first++;
+            } else {
+                *tail = list;
+                list = list->*Right;
+            }
+            tail = &((*tail)->*Right);
+        }
+        while (first != last) {
+            *tail = *first++;
+            tail = &((*tail)->*Right);
+        }
+        *tail = list;
+        return merged;
+    }
+
+    // Build a perfectly balanced tree from the first n nodes of the list.
+    static np_t build_from_list(np_t &list, std::size_t n) noexcept {
+        if (n == 0) {
+            return mock_sentinel();
+        }
+        np_t left = build_from_list(list, n / 2);
+        np_t root = list;
+        list = list->*Right;
+        root->*Left = left;
+        root->*Right = build_from_list(list, n - n / 2 - 1);
+        root->*Size = static_cast<nsize_t>(n);
+        return root;
+    }
+
     void winsert_multi_impl(np_t &root, np_t node) noexcept {
         if (is_sentinel(root)) [[unlikely]] {
             node->*Right = mock_sentinel();
@@ -304,13 +606,14 @@ struct irsbt<Right, Left, Size, CMP> {
             return nullptr;
         }
         np_t result;
-        if (cmp(node, *root)) {
+        auto order = cmp.compare(node, *root);
+        if (order < 0) {
             result = remove_unique_impl(root->*Left, node);
             if (result != nullptr) {
                 (root->*Size)--;
             }
             return result;
-        } else if (cmp(*root, node)) {
+        } else if (order > 0) {
             result = remove_unique_impl(root->*Right, node);
             if (result != nullptr) {
                 (root->*Size)--;
@@ -318,36 +621,65 @@ struct irsbt<Right, Left, Size, CMP> {
             return result;
         } else {
             result = root;
-            if (is_sentinel(root->*Right)) {
-                root = root->*Left;
-            } else if (is_sentinel(root->*Left)) { // Unnecessary branch!
-                root = root->*Right;
+            unlink(root);
+            return result;
+        }
+    }
+
+    // The node is found among the equivalent nodes in order. Only the subtrees that overlap the
+    // equivalent nodes are walked, so it's O(log n + d).
+    bool erase_impl(np_t &root, np_t node) noexcept {
+        if (is_sentinel(root)) [[unlikely]] {
+            return false;
+        }
+        bool result;
+        auto order = cmp.compare(*node, *root);
+        if (order < 0) {
+            result = erase_impl(root->*Left, node);
+        } else if (order > 0) {
+            result = erase_impl(root->*Right, node);
+        } else if (root == node) {
+            unlink(root);
+            return true;
+        } else {
+            result = erase_impl(root->*Left, node) || erase_impl(root->*Right, node);
+        }
+        if (result) {
+            (root->*Size)--;
+        }
+        return result;
+    }
+
+    // Replace the root by its successor, or by its left child if there is none.
+    static void unlink(np_t &root) noexcept {
+        if (is_sentinel(root->*Right)) {
+            root = root->*Left;
+        } else if (is_sentinel(root->*Left)) { // Unnecessary branch!
+            root = root->*Right;
+        } else {
+            np_t r = root->*Right;
+            if (is_sentinel(r->*Left)) {
+                r->*Left = root->*Left;
+                r->*Size = root->*Size - 1;
+                root = r;
             } else {
-                np_t r = root->*Right;
-                if (is_sentinel(r->*Left)) {
-                    r->*Left = root->*Left;
-                    r->*Size = root->*Size - 1;
-                    root = r;
-                } else {
-                    np_t sp = r;
-                    np_t s = sp->*Left;
+                np_t sp = r;
+                np_t s = sp->*Left;
 
+                (sp->*Size)--;
+                while (!is_sentinel(s->*Left)) {
+                    sp = s;
                     (sp->*Size)--;
-                    while (!is_sentinel(s->*Left)) {
-                        sp = s;
-                        (sp->*Size)--;
-                        s = s->*Left;
-                    }
-                    sp->*Left = s->*Right;
-
-                    s->*Right = r;
-                    s->*Left = root->*Left;
-                    s->*Size = root->*Size - 1;
-
-                    root = s;
+                    s = s->*Left;
                 }
+                sp->*Left = s->*Right;
+
+                s->*Right = r;
+                s->*Left = root->*Left;
+                s->*Size = root->*Size - 1;
+
+                root = s;
             }
-            return result;
         }
     }
 
@@ -355,9 +687,10 @@ struct irsbt<Right, Left, Size, CMP> {
     [[nodiscard]]
     np_t find_impl(const T *root, const K &node) const noexcept {
         while (!is_sentinel(root)) {
-            if (cmp(node, *root)) {
+            auto order = cmp.compare(node, *root);
+            if (order < 0) {
                 root = root->*Left;
-            } else if (cmp(*root, node)) {
+            } else if (order > 0) {
                 root = root->*Right;
             } else {
                 return const_cast<np_t>(root);
@@ -366,6 +699,57 @@ struct irsbt<Right, Left, Size, CMP> {
         return nullptr;
     }
 
+    template <typename K>
+    [[nodiscard]]
+    np_t lower_bound_impl(const T *root, const K &node) const noexcept {
+        const T *result = nullptr;
+        while (!is_sentinel(root)) {
+            if (cmp(*root, node)) {
+                root = root->*Right;
+            } else {
+                result = root;
+                root = root->*Left;
+            }
+        }
+        return const_cast<np_t>(result);
+    }
+
+    template <typename F>
+    static void for_each_impl(const T *root, F &f) {
+        if (is_sentinel(root)) {
+            return;
+        }
+        for_each_impl(root->*Left, f);
+        f(*const_cast<np_t>(root));
+        for_each_impl(root->*Right, f);
+    }
+
+    // The range is relative to the subtree, the subtrees that are fully covered are walked by
+    // for_each_impl, so only the two boundary paths are descended along the sizes.
+    template <typename F>
+    static void for_each_range_impl(const T *root, std::size_t first, std::size_t last, F &f) {
+        while (first < last) {
+            if ((first == 0) && (last == root->*Size)) {
+                for_each_impl(root, f);
+                return;
+            }
+            std::size_t lsize = root->*Left->*Size;
+            if (last <= lsize) {
+                root = root->*Left;
+                continue;
+            }
+            if (first <= lsize) {
+                for_each_range_impl(root->*Left, first, lsize, f);
+                f(*const_cast<np_t>(root));
+                first = 0;
+            } else {
+                first -= (lsize + 1);
+            }
+            last -= (lsize + 1);
+            root = root->*Right;
+        }
+    }
+
     [[nodiscard]]
     std::size_t height_impl(const T *root) const noexcept {
         if (is_sentinel(root)) {
@@ -380,11 +764,12 @@ struct irsbt<Right, Left, Size, CMP> {
     std::size_t position_impl(const T *root, const K &node) const noexcept {
         std::size_t pos = 0;
         while (!is_sentinel(root)) {
-            if (cmp(node, *root)) {
+            auto order = cmp.compare(node, *root);
+            if (order < 0) {
                 root = root->*Left;
             } else {
                 pos += (root->*Left->*Size + 1);
-                if (!cmp(*root, node)) {
+                if (order == 0) {
                     return pos - 1;
                 }
                 root = root->*Right;
@@ -398,9 +783,10 @@ struct irsbt<Right, Left, Size, CMP> {
         if (is_sentinel(root)) {
             return 0;
         }
-        if (cmp(node, *root)) {
+        auto order = cmp.compare(node, *root);
+        if (order < 0) {
             return count_multi_impl(root->*Left, node);
-        } else if (cmp(*root, node)) {
+        } else if (order > 0) {
             return count_multi_impl(root->*Right, node);
         } else {
             return 1 + count_multi_impl(root->*Right, node) + count_multi_impl(root->*Left, node);
@@ -415,6 +801,11 @@ struct irsbt<Right, Left, Size, CMP> {
             storage.*Size = 0;
         }
 
+        // The storage is never constructed, so it must not be destroyed, T may have non-trivial
+        // members such as std::string.
+        constexpr ~sentinel_t() {
+        }
+
         T storage;
         unsigned char buffer[sizeof(T)];
     };
@@ -431,9 +822,184 @@ struct irsbt<Right, Left, Size, CMP> {
 
     // TODO: need a macro for the msvc.
     [[no_unique_address]]
-    CMP cmp;
+    detail::comparator<CMP> cmp;
     T *head;
 };
 
+// The leftmost and rightmost nodes are cached, just like the rb_root_cached of Linux, so front()
+// and back() are O(1), and the insertion of a new max node doesn't compare all the way down.
+template <
+    auto Right,
+    auto Left,
+    auto Size,
+    typename CMP = std::less<>,
+    typename Balance = wbt_balance<>>
+class irsbt_cached : private irsbt<Right, Left, Size, CMP, Balance> {
+    using tree_t = irsbt<Right, Left, Size, CMP, Balance>;
+    using T = uit::container_t<Right>;
+   public:
+    using np_t = typename tree_t::np_t;
+    using nsize_t = typename tree_t::nsize_t;
+
+    using tree_t::is_sentinel;
+    using tree_t::empty;
+    using tree_t::size;
+    using tree_t::find;
+    using tree_t::lower_bound;
+    using tree_t::for_each;
+    using tree_t::for_each_range;
+    using tree_t::at;
+    using tree_t::position;
+    using tree_t::height;
+    using tree_t::count_multi;
+
+    irsbt_cached() noexcept
+        : m_leftmost{nullptr}
+        , m_rightmost{nullptr} {
+    }
+
+    void clear() noexcept {
+        tree_t::clear();
+        m_leftmost = nullptr;
+        m_rightmost = nullptr;
+    }
+
+    template <typename Disposer>
+    void clear_and_dispose(Disposer &&disposer) {
+        tree_t::clear_and_dispose(std::forward<Disposer>(disposer));
+        m_leftmost = nullptr;
+        m_rightmost = nullptr;
+    }
+
+    // Returns the leftmost node, or nullptr if the tree is empty.
+    [[nodiscard]]
+    np_t front() const noexcept {
+        return m_leftmost;
+    }
+
+    // Returns the rightmost node, or nullptr if the tree is empty.
+    [[nodiscard]]
+    np_t back() const noexcept {
+        return m_rightmost;
+    }
+
+    void insert_multi(np_t node) noexcept {
+        if (empty()) [[unlikely]] {
+            tree_t::insert_multi(node);
+            m_leftmost = node;
+            m_rightmost = node;
+        } else if (!cmp(*node, *m_rightmost)) {
+            // Equivalent nodes go right, so it's the new rightmost node.
+            tree_t::push_back_max(node);
+            m_rightmost = node;
+        } else {
+            tree_t::insert_multi(node);
+            if (cmp(*node, *m_leftmost)) {
+                m_leftmost = node;
+            }
+        }
+    }
+
+    // Returns the equivalent node in the tree if the insertion fails, otherwise returns nullptr.
+    np_t insert_unique(np_t node) noexcept {
+        np_t result = tree_t::insert_unique(node);
+        if (result == nullptr) {
+            update(node, node);
+        }
+        return result;
+    }
+
+    // The node must not be less than any node in the tree.
+    void push_back_max(np_t node) noexcept {
+        tree_t::push_back_max(node);
+        if (m_leftmost == nullptr) [[unlikely]] {
+            m_leftmost = node;
+        }
+        m_rightmost = node;
+    }
+
+    void insert_batch(std::span<np_t> batch) noexcept {
+        if (batch.empty()) [[unlikely]] {
+            return;
+        }
+        tree_t::insert_batch(batch);
+        // The batch is sorted now.
+        update(batch.front(), batch.back());
+    }
+
+    template <auto Key>
+        requires std::integral<uit::member_t<Key>> && std::same_as<uit::container_t<Key>, T>
+    void insert_batch(std::span<np_t> batch) {
+        if (batch.empty()) [[unlikely]] {
+            return;
+        }
+        tree_t::template insert_batch<Key>(batch);
+        update(batch.front(), batch.back());
+    }
+
+    // It's UB when the tree is empty, so you must check for emptiness before calling this function.
+    np_t pop_front() noexcept {
+        np_t node = tree_t::remove_leftmost(m_leftmost);
+        if (m_leftmost == nullptr) [[unlikely]] {
+            m_rightmost = nullptr;
+        }
+        return node;
+    }
+
+    // It's UB when the tree is empty, so you must check for emptiness before calling this function.
+    np_t pop_back() noexcept {
+        np_t node = tree_t::remove_rightmost(m_rightmost);
+        if (m_rightmost == nullptr) [[unlikely]] {
+            m_leftmost = nullptr;
+        }
+        return node;
+    }
+
+    np_t remove_leftmost() noexcept {
+        return pop_front();
+    }
+
+    np_t remove_rightmost() noexcept {
+        return pop_back();
+    }
+
+    template <typename K>
+    np_t remove_unique(const K &k) noexcept {
+        np_t node = tree_t::remove_unique(k);
+        if ((node == m_leftmost) || (node == m_rightmost)) [[unlikely]] {
+            // The walks are only required when the removed node is at either end.
+            m_leftmost = tree_t::front();
+            m_rightmost = tree_t::back();
+        }
+        return node;
+    }
+
+    bool erase(np_t node) noexcept {
+        if (!tree_t::erase(node)) {
+            return false;
+        }
+        if ((node == m_leftmost) || (node == m_rightmost)) [[unlikely]] {
+            m_leftmost = tree_t::front();
+            m_rightmost = tree_t::back();
+        }
+        return true;
+    }
+   private:
+    void update(np_t first, np_t last) noexcept {
+        if ((m_leftmost == nullptr) || cmp(*first, *m_leftmost)) {
+            m_leftmost = first;
+        }
+        if ((m_rightmost == nullptr) || !cmp(*last, *m_rightmost)) {
+            m_rightmost = last;
+        }
+    }
+
+    // TODO: need a macro for the msvc.
+    [[no_unique_address]]
+    detail::comparator<CMP> cmp;
+    np_t m_leftmost;
+    np_t m_rightmost;
+};
+
 } // namespace uit
 #endif
\ No newline at end of file
@@ -5,9 +5,16 @@
 #ifndef UIT_IRWBT_E773160D_0F94_4DD2_8A57_6FB1F0D3A109
 #define UIT_IRWBT_E773160D_0F94_4DD2_8A57_6FB1F0D3A109
 #include <uit/intrusive.hpp>
+#include <uit/detail/comparator.hpp>
 #include <uit/detail/top_down_queue.hpp>
+#include <uit/detail/radix_sort.hpp>
+#include <uit/wbt_balance.hpp>
+#include <algorithm>
+#include <concepts>
 #include <cstdint>
 #include <functional>
+#include <span>
+#include <utility>
 
 // References:
 // [0] Yoichi Hirai and Kazuhiko Yamamoto. Balancing weight-balanced trees. 2011.
@@ -17,11 +24,23 @@
 // [1] The mock sentinel will involve UB, but the code works correctly.
 // [2] This is a top-down implementation that avoids the need for some recursive approaches.
 namespace uit {
-template <auto Right, auto Left, auto Size, typename CMP = std::less<>>
+template <
+    auto Right,
+    auto Left,
+    auto Size,
+    typename CMP = std::less<>,
+    typename Balance = wbt_balance<>>
 struct irwbt;
 
-template <typename T, typename MT, MT T::*Right, MT T::*Left, auto Size, typename CMP>
-struct irwbt<Right, Left, Size, CMP> {
+template <
+    typename T,
+    typename MT,
+    MT T::*Right,
+    MT T::*Left,
+    auto Size,
+    typename CMP,
+    typename Balance>
+struct irwbt<Right, Left, Size, CMP, Balance> {
    public:
     using np_t = T *;
     using cnp_t = const T *;
@@ -45,12 +64,63 @@ struct irwbt<Right, Left, Size, CMP> {
         head = mock_sentinel();
     }
 
+    // The disposer is called on each node in order, it may free the node. The left child is rotated
+    // up until there is none, then the node is disposed and the walk goes right, so it's O(n) time
+    // and O(1) space, see boost.intrusive. The sizes aren't updated by the rotations.
+    template <typename Disposer>
+    void clear_and_dispose(Disposer &&disposer) {
+        np_t cur = head;
+        clear();
+        while (!is_sentinel(cur)) {
+            np_t left = cur->*Left;
+            if (!is_sentinel(left)) {
+                cur->*Left = left->*Right;
+                left->*Right = cur;
+                cur = left;
+            } else {
+                np_t right = cur->*Right;
+                disposer(cur);
+                cur = right;
+            }
+        }
+    }
+
     [[nodiscard]]
     std::size_t size() const noexcept {
         return head->*Size;
     }
 
     void insert_multi(np_t node) noexcept {
+        insert_multi(head, node);
+    }
+
+    void insert_multi_with_queue(np_t node) noexcept {
+        detail::top_down_queue<T> q{};
+        np_t *cur_ptr = &head;
+        np_t cur = head;
+        while (!is_sentinel(cur)) {
+            (cur->*Size)++;
+            if (cmp(*node, *cur)) {
+                q.push_left_path(cur_ptr);
+                cur_ptr = &(cur->*Left);
+            } else {
+                q.push_right_path(cur_ptr);
+                cur_ptr = &(cur->*Right);
+            }
+            if (q.size() > 3) {
+                top_down_insert_mainatin(q);
+            }
+            cur = *cur_ptr;
+        }
+        insert_leaf(*cur_ptr, node);
+        while (q.size() > 1) {
+            top_down_insert_mainatin(q);
+        }
+    }
+
+    // The node must not be less than any node in the tree, so it's always linked to the end of the
+    // rightmost spine. It's the right path of insert_multi without any comparison.
+    void push_back_max(np_t node) noexcept {
         np_t *cur_ptr = &head;
         np_t cur = head;
         if (is_sentinel(cur)) [[unlikely]] {
@@ -58,17 +128,524 @@ struct irwbt<Right, Left, Size, CMP> {
             return;
         }
         (cur->*Size)++;
+        while (1) {
+            np_t right = cur->*Right;
+            if (is_sentinel(right)) [[unlikely]] {
+                insert_leaf(cur->*Right, node);
+                return;
+            }
+            (right->*Size)++; // look-ahead-1
+            if (Balance::is_heavy(cur->*Left->*Size, right->*Size)) [[unlikely]] {
+                np_t rr = right->*Right;
+                nsize_t rr_size = rr->*Size + 1;
+                np_t *ptr = cur_ptr;
+                if (!is_sentinel(rr)) [[likely]] { // look-ahead-2
+                    (rr->*Size)++;
+                    cur_ptr = &(right->*Right);
+                } else {
+                    insert_leaf(right->*Right, node);
+                    cur_ptr = nullptr;
+                }
+                // rl.S = r.S - rr.S -1
+                if (Balance::is_double(right->*Size - rr_size - 1, rr_size)) { // double-rotate
+                    right_rotate(cur->*Right);
+                }
+                left_rotate(*ptr);
+                if (cur_ptr == nullptr) [[unlikely]] {
+                    return;
+                }
+                cur = *cur_ptr;
+            } else {
+                cur_ptr = &(cur->*Right);
+                cur = right;
+            }
+        }
+    }
+
+    // The hint must be the rightmost node, or nullptr if the tree is empty, it's trusted and not
+    // checked, since back() walks the right spine. Nodes don't have parent pointers, so the hint
+    // is only used as the maximum: if the new node isn't less than it, the node is pushed back
+    // without comparisons, otherwise it's equivalent to insert_multi. For a near-monotonic stream,
+    // the caller keeps the maximum of the inserted nodes as the hint.
+    void insert_hint(np_t hint, np_t node) noexcept {
+        if ((hint != nullptr) && !cmp(*node, *hint)) {
+            push_back_max(node);
+        } else {
+            insert_multi(node);
+        }
+    }
+
+    // Insert a batch of nodes, the batch is sorted in place. The batch is merged into the tree in
+    // one traversal: it's partitioned once at the root of each touched subtree, and each touched
+    // subtree is rebalanced once on the way back. A subtree that isn't larger than its part of the
+    // batch is merged with it into a list and rebuilt in linear time.
+    void insert_batch(std::span<np_t> batch) noexcept {
+        std::sort(batch.begin(), batch.end(), [this](np_t a, np_t b) { return cmp(*a, *b); });
+        insert_sorted_batch(batch.data(), batch.data() + batch.size());
+    }
+
+    // The same as above, but the batch is sorted by a radix sort on the integral key, so the order
+    // of the key must be the same as the order of CMP.
+    template <auto Key>
+        requires std::integral<uit::member_t<Key>> && std::same_as<uit::container_t<Key>, T>
+    void insert_batch(std::span<np_t> batch) {
+        detail::radix_sort<Key>(batch.data(), batch.data() + batch.size());
+        insert_sorted_batch(batch.data(), batch.data() + batch.size());
+    }
+
+    // Steal all nodes of the other tree, the other tree must not be this one and it becomes empty.
+    // It's a join-based union, O(m log(n/m + 1)) for the sizes m <= n, so a small tree is merged
+    // into a large one (or vice versa) without rebalancing the whole path of each node. Equivalent
+    // nodes of the other tree go after the ones of this tree.
+    void merge(irwbt &other) noexcept {
+        head = union_multi(head, other.head);
+        other.head = mock_sentinel();
+    }
+
+    // Both trees are unique. A node of the other tree that collides with a node of this tree stays
+    // in the other tree, just like std::set::merge.
+    void merge_unique(irwbt &other) noexcept {
+        np_t t2 = other.head;
+        other.head = mock_sentinel();
+        auto keep = [&other](T &, T &dropped) { other.insert_multi(other.head, &dropped); };
+        head = union_unique(head, t2, keep);
+    }
+
+    // The same as above, but the other tree becomes empty, and on_collision(kept, dropped) is called
+    // for each collision, the dropped node is in neither tree. on_collision must not touch the
+    // trees.
+    template <typename F>
+    void merge_unique(irwbt &other, F &&on_collision) {
+        np_t t2 = other.head;
+        other.head = mock_sentinel();
+        head = union_unique(head, t2, on_collision);
+    }
+
+    // insert unique
+    bool insert(np_t node) noexcept {
+        np_t *cur_ptr = &head;
+        np_t cur = head;
+        uint64_t path = 1; // Set a sentinel bit
+        using stack_t = np_t *;
+        stack_t stack[sizeof(path) * 8];
+        stack_t *stack_ptr = &stack[0];
+
+        while (!is_sentinel(cur)) {
+            path <<= 1;
+            *stack_ptr++ = cur_ptr;
+            auto order = cmp.compare(*node, *cur);
+            if (order < 0) {
+                cur_ptr = &(cur->*Left);
+            } else if (order > 0) {
+                path |= 1;
+                cur_ptr = &(cur->*Right);
+            } else {
+                return false;
+            }
+            cur = *cur_ptr;
+        }
+        insert_leaf(*cur_ptr, node);
+        stack_ptr--;
+        if (path > 1) [[likely]] {
+            // The parent node of the new leaf node is always balanced.
+            ((**stack_ptr)->*Size)++;
+            path >>= 1;
+            stack_ptr--;
+        }
+        while (path > 1) {
+            cur_ptr = *stack_ptr;
+            ((*cur_ptr)->*Size)++;
+            if (path & 1u) {
+                maintain_right_leaning(*cur_ptr);
+            } else {
+                maintain_left_leaning(*cur_ptr);
+            }
+            path >>= 1;
+            stack_ptr--;
+        }
+        return true;
+    }
+
+    // It's UB when the tree is empty, so you must check for emptiness before calling this function.
+    np_t remove_leftmost() noexcept {
+        np_t next;
+        return remove_leftmost(next);
+    }
+
+    // The same as above, and the new leftmost node is stored to "next", or nullptr if the tree
+    // becomes empty. Rotations don't change the order, so the successor of the removed node is found
+    // on the way: it's the leftmost node of its right subtree, or its parent.
+    np_t remove_leftmost(np_t &next) noexcept {
+        np_t *cur_ptr = &head;
+        np_t cur = head;
+        np_t parent = nullptr;
+
+        (cur->*Size)--;
+        while (!is_sentinel(cur->*Left)) {
+            (cur->*Left->*Size)--;
+            maintain_right_leaning(*cur_ptr);
+            parent = cur;
+            cur_ptr = &(cur->*Left);
+            cur = *cur_ptr;
+        }
+        *cur_ptr = cur->*Right;
+        next = is_sentinel(cur->*Right) ? parent : leftmost(cur->*Right);
+        return cur;
+    }
+
+    // It's UB when the tree is empty, so you must check for emptiness before calling this function.
+    np_t remove_rightmost() noexcept {
+        np_t prev;
+        return remove_rightmost(prev);
+    }
+
+    // The mirror of remove_leftmost, the new rightmost node is stored to "prev".
+    np_t remove_rightmost(np_t &prev) noexcept {
+        return remove_rightmost(head, prev);
+    }
+
+    // Remove the rightmost node and insert the node in one descent, the rightmost node is returned
+    // and the new one is stored to "last". The node must be less than the rightmost node, so the
+    // tree must not be empty. The right spine is shared until the node goes left, the sizes don't
+    // change there, since the subtree below loses the max and gains the node. Only that subtree is
+    // rebalanced, by the top-down removal and insertion of its own, so the common prefix is walked
+    // once without any rotation, and a node that goes left at the root costs two passes at most.
+    np_t replace_max(np_t node, np_t &last) noexcept {
+        np_t *cur_ptr = &head;
+        np_t cur = head;
+        np_t parent = nullptr;
+        while (!cmp(*node, *cur)) {
+            parent = cur;
+            cur_ptr = &(cur->*Right);
+            cur = *cur_ptr;
+        }
+        np_t prev;
+        np_t max = remove_rightmost(*cur_ptr, prev);
+        if (prev == nullptr) {
+            prev = parent;
+        }
+        insert_multi(*cur_ptr, node);
+        // Equivalent nodes go right, so the node is the last one if it isn't less than "prev".
+        last = ((prev == nullptr) || !cmp(*node, *prev)) ? node : prev;
+        return max;
+    }
+
+    template <typename K>
+    np_t remove(const K &node) noexcept {
+        np_t cur = head;
+        uint64_t path{};
+
+        for (unsigned i{}; !is_sentinel(cur); i++) {
+            auto order = cmp.compare(node, *cur);
+            if (order < 0) {
+                cur = cur->*Left;
+            } else if (order > 0) {
+                cur = cur->*Right;
+                path |= (uint64_t{1} << i);
+            } else {
+                path |= (uint64_t{1} << i); // Set a sentinel bit.
+                return remove_path(path);
+            }
+        }
+        return nullptr;
+    }
+
+    // Remove exactly the node, even if there are other equivalent nodes. The equivalent nodes are
+    // adjacent in order, so they're walked in order from the first one until the node is met, it's
+    // O(log n + d), where d is the number of equivalent nodes. It's O(log n) with the
+    // address_tiebreak comparator, since there are no equivalent nodes. Returns false if the node
+    // isn't in the tree.
+    bool erase(np_t node) noexcept {
+        if constexpr (is_template_instance_of_v<CMP, address_tiebreak>) {
+            return remove(*node) != nullptr;
+        } else {
+            uint64_t path;
+            if (!find_path(node, path)) {
+                return false;
+            }
+            remove_path(path);
+            return true;
+        }
+    }
+
+    template <typename K>
+    [[nodiscard]]
+    np_t find(const K &key) const noexcept {
+        cnp_t cur = head;
+        while (!is_sentinel(cur)) {
+            auto order = cmp.compare(key, *cur);
+            if (order < 0) {
+                cur = cur->*Left;
+            } else if (order > 0) {
+                cur = cur->*Right;
+            } else {
+                return const_cast<np_t>(cur);
+            }
+        }
+        return nullptr;
+    }
+
+    // Returns the first node that is not less than the key, or nullptr if there is no such node.
+    template <typename K>
+    [[nodiscard]]
+    np_t lower_bound(const K &key) const noexcept {
+        cnp_t cur = head;
+        cnp_t result = nullptr;
+        while (!is_sentinel(cur)) {
+            if (cmp(*cur, key)) {
+                cur = cur->*Right;
+            } else {
+                result = cur;
+                cur = cur->*Left;
+            }
+        }
+        return const_cast<np_t>(result);
+    }
+
+    // In-order traversal without recursion, the height of the tree is always less than 64.
+    template <typename F>
+    void for_each(F &&f) const {
+        cnp_t stack[sizeof(uint64_t) * 8];
+        cnp_t *stack_ptr = &stack[0];
+        cnp_t cur = head;
+
+        while (true) {
+            while (!is_sentinel(cur)) {
+                *stack_ptr++ = cur;
+                cur = cur->*Left;
+            }
+            if (stack_ptr == &stack[0]) {
+                break;
+            }
+            cur = *--stack_ptr;
+            f(*const_cast<np_t>(cur));
+            cur = cur->*Right;
+        }
+    }
+
+    // In-order traversal of the nodes whose ranks are in [first, last), it requires
+    // first <= last <= size(). The first node is reached by one descent along the sizes, so the
+    // traversal can be split into chunks without scanning, see parallel_for_each.
+    template <typename F>
+    void for_each_range(std::size_t first, std::size_t last, F &&f) const {
+        cnp_t stack[sizeof(uint64_t) * 8];
+        cnp_t *stack_ptr = &stack[0];
+        cnp_t cur = head;
+        std::size_t count = last - first;
+
+        if (count == 0) {
+            return;
+        }
+        while (true) {
+            std::size_t lsize = cur->*Left->*Size;
+            if (first < lsize) {
+                *stack_ptr++ = cur;
+                cur = cur->*Left;
+            } else if (first > lsize) {
+                first -= (lsize + 1);
+                cur = cur->*Right;
+            } else {
+                break;
+            }
+        }
+        while (true) {
+            f(*const_cast<np_t>(cur));
+            if (--count == 0) {
+                break;
+            }
+            cur = cur->*Right;
+            while (!is_sentinel(cur)) {
+                *stack_ptr++ = cur;
+                cur = cur->*Left;
+            }
+            cur = *--stack_ptr;
+        }
+    }
+
+    // Returns the leftmost node, or nullptr if the tree is empty. It's O(log n), see irwbt_cached
+    // for O(1).
+    [[nodiscard]]
+    np_t front() const noexcept {
+        return empty() ? nullptr : leftmost(head);
+    }
+
+    // Returns the rightmost node, or nullptr if the tree is empty.
+    [[nodiscard]]
+    np_t back() const noexcept {
+        return empty() ? nullptr : rightmost(head);
+    }
+
+    [[nodiscard]]
+    std::size_t height() const noexcept {
+        return height_impl(head);
+    }
+
+    static bool validate_sentinel() noexcept {
+        auto s = const_mock_sentinel();
+        return (s->*Right == s) && (s->*Left == s) && (s->*Size == 0);
+    }
+   private:
+    // Bit i of the path is the direction at depth i, 1 for right, and the highest set bit marks the
+    // depth of the node to be removed. The tree is maintained top-down along the path, the rotations
+    // don't change the subtree below the current node, so the path stays valid.
+    np_t remove_path(uint64_t path) noexcept {
+        np_t *cur_ptr = &head;
+        np_t cur = *cur_ptr;
+        (cur->*Size)--;
+        while (path > 1) {
+            if (path & 1) {
+                (cur->*Right->*Size)--;
+                maintain_left_leaning(*cur_ptr);
+                cur_ptr = &(cur->*Right);
+            } else {
+                (cur->*Left->*Size)--;
+                maintain_right_leaning(*cur_ptr);
+                cur_ptr = &(cur->*Left);
+            }
+            cur = *cur_ptr;
+            path >>= 1;
+        }
+        np_t right = cur->*Right;
+        if (is_sentinel(right)) [[unlikely]] {
+            *cur_ptr = cur->*Left;
+        } else {
+            if (is_sentinel(right->*Left)) [[unlikely]] {
+                right->*Left = cur->*Left;
+                right->*Size = cur->*Size;
+                *cur_ptr = right;
+            } else {
+                np_t leftmost = top_down_remove_leftmost_for_remove(&(cur->*Right));
+                leftmost->*Right = cur->*Right;
+                leftmost->*Left = cur->*Left;
+                leftmost->*Size = cur->*Size;
+                *cur_ptr = leftmost;
+            }
+            maintain_left_leaning(*cur_ptr);
+        }
+        return cur;
+    }
+
+    // Find the path of the node in the form of remove_path. It starts from the first node that is
+    // not less than the node, and walks in order with the stack of the path.
+    bool find_path(cnp_t node, uint64_t &path) const noexcept {
+        cnp_t stack[sizeof(uint64_t) * 8];
+        unsigned depth = 0;
+        unsigned first = 0;
+        bool found = false;
+        cnp_t cur = head;
+
+        path = 0;
+        while (!is_sentinel(cur)) {
+            stack[depth] = cur;
+            if (cmp(*cur, *node)) {
+                path |= (uint64_t{1} << depth);
+                cur = cur->*Right;
+            } else {
+                path &= ~(uint64_t{1} << depth);
+                first = depth;
+                found = true;
+                cur = cur->*Left;
+            }
+            depth++;
+        }
+        if (!found) {
+            return false;
+        }
+        depth = first;
+        while (1) {
+            cur = stack[depth];
+            if (cur == node) {
+                path = (path & ((uint64_t{1} << depth) - 1)) | (uint64_t{1} << depth);
+                return true;
+            }
+            if (cmp(*node, *cur)) {
+                return false;
+            }
+            if (!is_sentinel(cur->*Right)) {
+                path |= (uint64_t{1} << depth);
+                stack[++depth] = cur->*Right;
+                while (!is_sentinel(stack[depth]->*Left)) {
+                    path &= ~(uint64_t{1} << depth);
+                    stack[depth + 1] = stack[depth]->*Left;
+                    depth++;
+                }
+            } else {
+                // Go up until the walk comes from a left child, the parent is the successor.
+                while ((depth > 0) && ((path >> (depth - 1)) & 1)) {
+                    depth--;
+                }
+                if (depth == 0) {
+                    return false;
+                }
+                depth--;
+            }
+        }
+    }
+
+    // The subtree version of remove_rightmost, "prev" is nullptr if the subtree becomes empty.
+    np_t remove_rightmost(np_t &root, np_t &prev) noexcept {
+        np_t *cur_ptr = &root;
+        np_t cur = root;
+        np_t parent = nullptr;
+
+        (cur->*Size)--;
+        while (!is_sentinel(cur->*Right)) {
+            (cur->*Right->*Size)--;
+            maintain_left_leaning(*cur_ptr);
+            parent = cur;
+            cur_ptr = &(cur->*Right);
+            cur = *cur_ptr;
+        }
+        *cur_ptr = cur->*Left;
+        prev = is_sentinel(cur->*Left) ? parent : rightmost(cur->*Left);
+        return cur;
+    }
+
+    // The root must not be the sentinel.
+    static np_t leftmost(np_t root) noexcept {
+        while (!is_sentinel(root->*Left)) {
+            root = root->*Left;
+        }
+        return root;
+    }
+
+    static np_t rightmost(np_t root) noexcept {
+        while (!is_sentinel(root->*Right)) {
+            root = root->*Right;
+        }
+        return root;
+    }
+
+    [[nodiscard]]
+    static std::size_t height_impl(const T *root) noexcept {
+        if (is_sentinel(root)) {
+            return 0;
+        }
+        std::size_t left_height = height_impl(root->*Left);
+        std::size_t right_height = height_impl(root->*Right);
+        return (left_height > right_height ? left_height : right_height) + 1;
+    }
+
+    // Top-down insertion into the subtree, it's the whole tree in most cases.
+    void insert_multi(np_t &root, np_t node) noexcept {
+        np_t *cur_ptr = &root;
+        np_t cur = root;
+        if (is_sentinel(cur)) [[unlikely]] {
+            insert_leaf(*cur_ptr, node);
+            return;
+        }
+        (cur->*Size)++;
         while (1) {
             if (cmp(*node, *cur)) { // l
                 np_t left = cur->*Left;
                 if (!is_sentinel(left)) [[likely]] { // look-ahead-1
                     (left->*Size)++;
-                    if ((cur->*Right->*Size * 3 + 1) < left->*Size) [[unlikely]] {
+                    if (Balance::is_heavy(cur->*Right->*Size, left->*Size)) [[unlikely]] {
                         bool is_ll = cmp(*node, *left);
                         nsize_t ll_size = is_ll ? (left->*Left->*Size + 1) : left->*Left->*Size;
                         np_t *ptr = cur_ptr;
                         // lr.S = l.S - ll.S -1
-                        if (ll_size * 2 < (left->*Size - ll_size)) { // double-rotate
+                        if (Balance::is_double(left->*Size - ll_size - 1, ll_size)) { // double-rotate
                             if (is_ll) {                             // ll
                                 np_t ll = left->*Left;
                                 if (!is_sentinel(ll)) [[likely]] { // look-ahead-2
@@ -144,12 +721,12 @@ struct irwbt<Right, Left, Size, CMP> {
                 np_t right = cur->*Right;
                 if (!is_sentinel(right)) [[likely]] { // look-ahead-1
                     (right->*Size)++;
-                    if ((cur->*Left->*Size * 3 + 1) < right->*Size) [[unlikely]] {
+                    if (Balance::is_heavy(cur->*Left->*Size, right->*Size)) [[unlikely]] {
                         bool is_rr = !cmp(*node, *right);
                         nsize_t rr_size = is_rr ? (right->*Right->*Size + 1) : right->*Right->*Size;
                         np_t *ptr = cur_ptr;
                         // rl.S = r.S - rr.S -1
-                        if (rr_size * 2 < (right->*Size - rr_size)) { // double-rotate
+                        if (Balance::is_double(right->*Size - rr_size - 1, rr_size)) { // double-rotate
                             if (is_rr) {                              // rr
                                 np_t rr = right->*Right;
                                 if (!is_sentinel(rr)) [[likely]] { // look-ahead-2
@@ -225,154 +802,214 @@ struct irwbt<Right, Left, Size, CMP> {
         }
     }
 
-    void insert_multi_with_queue(np_t node) noexcept {
-        detail::top_down_queue<T> q{};
-        np_t *cur_ptr = &head;
-        np_t cur = head;
-        while (!is_sentinel(cur)) {
-            (cur->*Size)++;
-            if (cmp(*node, *cur)) {
-                q.push_left_path(cur_ptr);
-                cur_ptr = &(cur->*Left);
-            } else {
-                q.push_right_path(cur_ptr);
-                cur_ptr = &(cur->*Right);
-            }
-            if (q.size() > 3) {
-                top_down_insert_mainatin(q);
-            }
-            cur = *cur_ptr;
+    void insert_sorted_batch(np_t *first, np_t *last) noexcept {
+        insert_batch_impl(head, first, last);
+    }
+
+    void insert_batch_impl(np_t &root, np_t *first, np_t *last) noexcept {
+        if (first == last) {
+            return;
         }
-        insert_leaf(*cur_ptr, node);
-        while (q.size() > 1) {
-            top_down_insert_mainatin(q);
+        std::size_t k = static_cast<std::size_t>(last - first);
+        if (k == 1) {
+            insert_multi(root, *first);
+            return;
         }
+        std::size_t n = root->*Size;
+        // It's cheaper to rebuild the subtree when the batch isn't smaller than it, and the empty
+        // subtree is handled by the way.
+        if (k >= n) {
+            np_t list = merge_to_list(flatten(root, mock_sentinel()), first, last);
+            root = build_from_list(list, n + k);
+            return;
+        }
+        // Equivalent nodes go right, just like insert_multi.
+        np_t *mid = std::partition_point(
+            first, last, [this, root](np_t node) { return cmp(*node, *root); });
+        insert_batch_impl(root->*Left, first, mid);
+        insert_batch_impl(root->*Right, mid, last);
+        root->*Size += static_cast<nsize_t>(k);
+        rebalance(root);
     }
 
-    // insert unique
-    bool insert(np_t node) noexcept {
-        np_t *cur_ptr = &head;
-        np_t cur = head;
-        uint64_t path = 1; // Set a sentinel bit
-        using stack_t = np_t *;
-        stack_t stack[sizeof(path) * 8];
-        stack_t *stack_ptr = &stack[0];
+    // All nodes of the left tree are not greater than the node, and the node is not greater than all
+    // nodes of the right tree. The lighter tree is linked on the spine of the heavier one where the
+    // sizes are balanced, and the spine is rebalanced on the way back.
+    static np_t join(np_t left, np_t node, np_t right) noexcept {
+        if (Balance::is_heavy(left->*Size, right->*Size)) {
+            right->*Left = join(left, node, right->*Left);
+            right->*Size += left->*Size + 1;
+            rebalance(right);
+            return right;
+        }
+        if (Balance::is_heavy(right->*Size, left->*Size)) {
+            left->*Right = join(left->*Right, node, right);
+            left->*Size += right->*Size + 1;
+            rebalance(left);
+            return left;
+        }
+        node->*Left = left;
+        node->*Right = right;
+        node->*Size = left->*Size + right->*Size + 1;
+        return node;
+    }
 
-        while (!is_sentinel(cur)) {
-            path <<= 1;
-            *stack_ptr++ = cur_ptr;
-            if (CMP{}(*node, *cur)) {
-                cur_ptr = &(cur->*Left);
-            } else if (CMP{}(*cur, *node)) {
-                path |= 1;
-                cur_ptr = &(cur->*Right);
-            } else {
-                return false;
-            }
-            cur = *cur_ptr;
+    // The left part is less than the key, and the right part is not less than the key.
+    void split(np_t root, const T &key, np_t &left, np_t &right) const noexcept {
+        if (is_sentinel(root)) {
+            left = root;
+            right = root;
+            return;
         }
-        insert_leaf(*cur_ptr, node);
-        stack_ptr--;
-        if (path > 1) [[likely]] {
-            // The parent node of the new leaf node is always balanced.
-            ((**stack_ptr)->*Size)++;
-            path >>= 1;
-            stack_ptr--;
+        np_t l = root->*Left;
+        np_t r = root->*Right;
+        if (cmp(*root, key)) {
+            split(r, key, r, right);
+            left = join(l, root, r);
+        } else {
+            split(l, key, left, l);
+            right = join(l, root, r);
         }
-        while (path > 1) {
-            cur_ptr = *stack_ptr;
-            ((*cur_ptr)->*Size)++;
-            if (path & 1u) {
-                maintain_right_leaning(*cur_ptr);
-            } else {
-                maintain_left_leaning(*cur_ptr);
-            }
-            path >>= 1;
-            stack_ptr--;
+    }
+
+    // The same as above, but the node equivalent to the key is returned rather than put into any
+    // part, or nullptr if there is no such node.
+    np_t split_unique(np_t root, const T &key, np_t &left, np_t &right) const noexcept {
+        if (is_sentinel(root)) {
+            left = root;
+            right = root;
+            return nullptr;
         }
-        return true;
+        np_t l = root->*Left;
+        np_t r = root->*Right;
+        np_t mid;
+        auto order = cmp.compare(*root, key);
+        if (order < 0) {
+            mid = split_unique(r, key, r, right);
+            left = join(l, root, r);
+        } else if (order > 0) {
+            mid = split_unique(l, key, left, l);
+            right = join(l, root, r);
+        } else {
+            left = l;
+            right = r;
+            mid = root;
+        }
+        return mid;
     }
 
-    // It's UB when the tree is empty, so you must check for emptiness before calling this function.
-    np_t remove_leftmost() noexcept {
-        np_t *cur_ptr = &head;
-        np_t cur = head;
+    // The second tree is split by the root of the first one, the equivalent nodes of the second tree
+    // go right, so they're after the ones of the first tree.
+    np_t union_multi(np_t t1, np_t t2) noexcept {
+        if (is_sentinel(t2)) {
+            return t1;
+        }
+        if (is_sentinel(t1)) {
+            return t2;
+        }
+        np_t l2;
+        np_t r2;
+        split(t2, *t1, l2, r2);
+        np_t l = union_multi(t1->*Left, l2);
+        np_t r = union_multi(t1->*Right, r2);
+        return join(l, t1, r);
+    }
 
-        (cur->*Size)--;
-        while (!is_sentinel(cur->*Left)) {
-            (cur->*Left->*Size)--;
-            maintain_right_leaning(*cur_ptr);
-            cur_ptr = &(cur->*Left);
-            cur = *cur_ptr;
+    template <typename F>
+    np_t union_unique(np_t t1, np_t t2, F &on_collision) {
+        if (is_sentinel(t2)) {
+            return t1;
         }
-        *cur_ptr = cur->*Right;
-        return cur;
+        if (is_sentinel(t1)) {
+            return t2;
+        }
+        np_t l2;
+        np_t r2;
+        np_t dropped = split_unique(t2, *t1, l2, r2);
+        np_t l = union_unique(t1->*Left, l2, on_collision);
+        np_t r = union_unique(t1->*Right, r2, on_collision);
+        np_t root = join(l, t1, r);
+        if (dropped != nullptr) {
+            on_collision(*t1, *dropped);
+        }
+        return root;
     }
 
-    template <typename K>
-    np_t remove(const K &node) noexcept {
-        np_t cur = head;
-        uint64_t path{};
+    [[nodiscard]]
+    static bool is_balanced(const T *root) noexcept {
+        return !Balance::is_heavy(root->*Left->*Size, root->*Right->*Size)
+            && !Balance::is_heavy(root->*Right->*Size, root->*Left->*Size);
+    }
 
-        for (unsigned i{}; !is_sentinel(cur); i++) {
-            if (cmp(node, *cur)) {
-                cur = cur->*Left;
-            } else if (cmp(*cur, node)) {
-                cur = cur->*Right;
-                path |= (uint64_t{1} << i);
-            } else {
-                path |= (uint64_t{1} << i); // Set a sentinel bit.
+    // The children are balanced. A rotation is enough for a slight imbalance, otherwise the subtree
+    // is rebuilt.
+    static void rebalance(np_t &root) noexcept {
+        if (is_balanced(root)) [[likely]] {
+            return;
+        }
+        if (root->*Left->*Size < root->*Right->*Size) {
+            maintain_right_leaning(root);
+        } else {
+            maintain_left_leaning(root);
+        }
+        if (is_balanced(root) && is_balanced(root->*Left) && is_balanced(root->*Right)) {
+            return;
+        }
+        std::size_t n = root->*Size;
+        np_t list = flatten(root, mock_sentinel());
+        root = build_from_list(list, n);
+    }
+    // Flatten the subtree into a list linked by the right child in order, and append the tail.
+    static np_t flatten(np_t root, np_t tail) noexcept {
+        while (!is_sentinel(root)) {
+            root->*Right = flatten(root->*Right, tail);
+            tail = root;
+            root = root->*Left;
+        }
+        return tail;
+    }
 
-                np_t *cur_ptr = &head;
-                cur = *cur_ptr;
-                (cur->*Size)--;
-                while (path > 1) {
-                    if (path & 1) {
-                        (cur->*Right->*Size)--;
-                        maintain_left_leaning(*cur_ptr);
-                        cur_ptr = &(cur->*Right);
-                    } else {
-                        (cur->*Left->*Size)--;
-                        maintain_right_leaning(*cur_ptr);
-                        cur_ptr = &(cur->*Left);
-                    }
-                    cur = *cur_ptr;
-                    path >>= 1;
-                }
-                np_t right = cur->*Right;
-                if (is_sentinel(right)) [[unlikely]] {
-                    *cur_ptr = cur->*Left;
-                } else {
-                    if (is_sentinel(right->*Left)) [[unlikely]] {
-                        right->*Left = cur->*Left;
-                        right->*Size = cur->*Size;
-                        *cur_ptr = right;
-                    } else {
-                        np_t leftmost = top_down_remove_leftmost_for_remove(&(cur->*Right));
-                        leftmost->*Right = cur->*Right;
-                        leftmost->*Left = cur->*Left;
-                        leftmost->*Size = cur->*Size;
-                        *cur_ptr = leftmost;
-                    }
-                    maintain_left_leaning(*cur_ptr);
-                }
-                return cur;
+    // Merge a sorted array into a sorted list, equivalent nodes of the array go after the list.
+    np_t merge_to_list(np_t list, np_t *first, np_t *last) noexcept {
+        np_t merged = mock_sentinel();
+        np_t *tail = &merged;
+        while (!is_sentinel(list) && (first != last)) {
+            if (cmp(**first, *list)) {
+                *tail = *first++;
+            } else {
+                *tail = list;
+                list = list->*Right;
             }
+            tail = &((*tail)->*Right);
         }
-        return nullptr;
+        while (first != last) {
+            *tail = *first++;
+            tail = &((*tail)->*Right);
+        }
+        *tail = list;
+        return merged;
     }
 
-    static bool validate_sentinel() noexcept {
-        auto s = const_mock_sentinel();
-        return (s->*Right == s) && (s->*Left == s) && (s->*Size == 0);
+    // Build a perfectly balanced tree from the first n nodes of the list.
+    static np_t build_from_list(np_t &list, std::size_t n) noexcept {
+        if (n == 0) {
+            return mock_sentinel();
+        }
+        np_t left = build_from_list(list, n / 2);
+        np_t root = list;
+        list = list->*Right;
+        root->*Left = left;
+        root->*Right = build_from_list(list, n - n / 2 - 1);
+        root->*Size = static_cast<nsize_t>(n);
+        return root;
     }
-   private:
+
     static void top_down_insert_mainatin(detail::top_down_queue<T> &q) noexcept {
         auto cur_ptr = q.front_pointer();
         np_t cur = *cur_ptr;
         if (q.path_queue() & 1u) { // Right?
-            if ((cur->*Left->*Size * 3 + 1) < cur->*Right->*Size) {
-                if (cur->*Right->*Right->*Size * 2 < (cur->*Right->*Left->*Size + 1)) {
+            if (Balance::is_heavy(cur->*Left->*Size, cur->*Right->*Size)) {
+                if (Balance::is_double(cur->*Right->*Left->*Size, cur->*Right->*Right->*Size)) {
                     right_rotate(cur->*Right);
                     left_rotate(*cur_ptr);
 
@@ -402,8 +1039,8 @@ struct irwbt<Right, Left, Size, CMP> {
                 q.pop();
             }
         } else { // Left
-            if ((cur->*Right->*Size * 3 + 1) < cur->*Left->*Size) {
-                if (cur->*Left->*Left->*Size * 2 < (cur->*Left->*Right->*Size + 1)) {
+            if (Balance::is_heavy(cur->*Right->*Size, cur->*Left->*Size)) {
+                if (Balance::is_double(cur->*Left->*Right->*Size, cur->*Left->*Left->*Size)) {
                     left_rotate(cur->*Left);
                     right_rotate(*cur_ptr);
 
@@ -470,8 +1107,8 @@ struct irwbt<Right, Left, Size, CMP> {
     }
 
     static void maintain_right_leaning(np_t &root) noexcept {
-        if ((root->*Left->*Size * 3 + 1) < root->*Right->*Size) [[unlikely]] {
-            if (root->*Right->*Right->*Size * 2 < (root->*Right->*Left->*Size + 1)) {
+        if (Balance::is_heavy(root->*Left->*Size, root->*Right->*Size)) [[unlikely]] {
+            if (Balance::is_double(root->*Right->*Left->*Size, root->*Right->*Right->*Size)) {
                 right_rotate(root->*Right);
             }
             left_rotate(root);
@@ -479,8 +1116,8 @@ struct irwbt<Right, Left, Size, CMP> {
     }
 
     static void maintain_left_leaning(np_t &root) noexcept {
-        if ((root->*Right->*Size * 3 + 1) < root->*Left->*Size) [[unlikely]] {
-            if (root->*Left->*Left->*Size * 2 < (root->*Left->*Right->*Size + 1)) {
+        if (Balance::is_heavy(root->*Right->*Size, root->*Left->*Size)) [[unlikely]] {
+            if (Balance::is_double(root->*Left->*Right->*Size, root->*Left->*Left->*Size)) {
                 left_rotate(root->*Left);
             }
             right_rotate(root);
@@ -502,6 +1139,11 @@ struct irwbt<Right, Left, Size, CMP> {
             storage.*Size = 0;
         }
 
+        // The storage is never constructed, so it must not be destroyed, T may have non-trivial
+        // members such as std::string.
+        constexpr ~sentinel_t() {
+        }
+
         T storage;
         unsigned char buffer[sizeof(T)];
     };
@@ -519,8 +1161,215 @@ struct irwbt<Right, Left, Size, CMP> {
 
     // TODO: need a macro for the msvc.
     [[no_unique_address]]
-    CMP cmp;
+    detail::comparator<CMP> cmp;
     T *head;
 };
+// The leftmost and rightmost nodes are cached, just like the rb_root_cached of Linux, so front()
+// and back() are O(1), and the insertion of a new max node doesn't compare all the way down.
+template <
+    auto Right,
+    auto Left,
+    auto Size,
+    typename CMP = std::less<>,
+    typename Balance = wbt_balance<>>
+class irwbt_cached : private irwbt<Right, Left, Size, CMP, Balance> {
+    using tree_t = irwbt<Right, Left, Size, CMP, Balance>;
+    using T = uit::container_t<Right>;
+   public:
+    using np_t = typename tree_t::np_t;
+    using cnp_t = typename tree_t::cnp_t;
+    using nsize_t = typename tree_t::nsize_t;
+
+    using tree_t::is_sentinel;
+    using tree_t::empty;
+    using tree_t::size;
+    using tree_t::find;
+    using tree_t::lower_bound;
+    using tree_t::for_each;
+    using tree_t::for_each_range;
+    using tree_t::height;
+    using tree_t::validate_sentinel;
+
+    irwbt_cached() noexcept
+        : m_leftmost{nullptr}
+        , m_rightmost{nullptr} {
+    }
+
+    void clear() noexcept {
+        tree_t::clear();
+        m_leftmost = nullptr;
+        m_rightmost = nullptr;
+    }
+
+    template <typename Disposer>
+    void clear_and_dispose(Disposer &&disposer) {
+        tree_t::clear_and_dispose(std::forward<Disposer>(disposer));
+        m_leftmost = nullptr;
+        m_rightmost = nullptr;
+    }
+
+    // Returns the leftmost node, or nullptr if the tree is empty.
+    [[nodiscard]]
+    np_t front() const noexcept {
+        return m_leftmost;
+    }
+
+    // Returns the rightmost node, or nullptr if the tree is empty.
+    [[nodiscard]]
+    np_t back() const noexcept {
+        return m_rightmost;
+    }
+
+    void insert_multi(np_t node) noexcept {
+        if (empty()) [[unlikely]] {
+            tree_t::insert_multi(node);
+            m_leftmost = node;
+            m_rightmost = node;
+        } else if (!cmp(*node, *m_rightmost)) {
+            // Equivalent nodes go right, so it's the new rightmost node.
+            tree_t::push_back_max(node);
+            m_rightmost = node;
+        } else {
+            tree_t::insert_multi(node);
+            if (cmp(*node, *m_leftmost)) {
+                m_leftmost = node;
+            }
+        }
+    }
+
+    // insert unique
+    bool insert(np_t node) noexcept {
+        if (!tree_t::insert(node)) {
+            return false;
+        }
+        update(node, node);
+        return true;
+    }
+
+    void merge(irwbt_cached &other) noexcept {
+        tree_t::merge(other);
+        update_ends();
+        other.update_ends();
+    }
+
+    void merge_unique(irwbt_cached &other) noexcept {
+        tree_t::merge_unique(other);
+        update_ends();
+        other.update_ends();
+    }
+
+    template <typename F>
+    void merge_unique(irwbt_cached &other, F &&on_collision) {
+        tree_t::merge_unique(other, on_collision);
+        update_ends();
+        other.update_ends();
+    }
+
+    // The node must not be less than any node in the tree.
+    void push_back_max(np_t node) noexcept {
+        tree_t::push_back_max(node);
+        if (m_leftmost == nullptr) [[unlikely]] {
+            m_leftmost = node;
+        }
+        m_rightmost = node;
+    }
+
+    void insert_batch(std::span<np_t> batch) noexcept {
+        if (batch.empty()) [[unlikely]] {
+            return;
+        }
+        tree_t::insert_batch(batch);
+        // The batch is sorted now.
+        update(batch.front(), batch.back());
+    }
+
+    template <auto Key>
+        requires std::integral<uit::member_t<Key>> && std::same_as<uit::container_t<Key>, T>
+    void insert_batch(std::span<np_t> batch) {
+        if (batch.empty()) [[unlikely]] {
+            return;
+        }
+        tree_t::template insert_batch<Key>(batch);
+        update(batch.front(), batch.back());
+    }
+
+    // It's UB when the tree is empty, so you must check for emptiness before calling this function.
+    np_t pop_front() noexcept {
+        np_t node = tree_t::remove_leftmost(m_leftmost);
+        if (m_leftmost == nullptr) [[unlikely]] {
+            m_rightmost = nullptr;
+        }
+        return node;
+    }
+
+    // It's UB when the tree is empty, so you must check for emptiness before calling this function.
+    np_t pop_back() noexcept {
+        np_t node = tree_t::remove_rightmost(m_rightmost);
+        if (m_rightmost == nullptr) [[unlikely]] {
+            m_leftmost = nullptr;
+        }
+        return node;
+    }
+
+    // Pop the max and push the node in one descent, see irwbt::replace_max. The node must be less
+    // than the max.
+    np_t replace_max(np_t node) noexcept {
+        np_t max = tree_t::replace_max(node, m_rightmost);
+        if (cmp(*node, *m_leftmost)) {
+            m_leftmost = node;
+        }
+        return max;
+    }
+
+    np_t remove_leftmost() noexcept {
+        return pop_front();
+    }
+
+    np_t remove_rightmost() noexcept {
+        return pop_back();
+    }
+
+    template <typename K>
+    np_t remove(const K &key) noexcept {
+        np_t node = tree_t::remove(key);
+        if ((node == m_leftmost) || (node == m_rightmost)) [[unlikely]] {
+            // The walks are only required when the removed node is at either end.
+            m_leftmost = tree_t::front();
+            m_rightmost = tree_t::back();
+        }
+        return node;
+    }
+
+    bool erase(np_t node) noexcept {
+        if (!tree_t::erase(node)) {
+            return false;
+        }
+        if ((node == m_leftmost) || (node == m_rightmost)) [[unlikely]] {
+            m_leftmost = tree_t::front();
+            m_rightmost = tree_t::back();
+        }
+        return true;
+    }
+   private:
+    void update_ends() noexcept {
+        m_leftmost = tree_t::front();
+        m_rightmost = tree_t::back();
+    }
+
+    void update(np_t first, np_t last) noexcept {
+        if ((m_leftmost == nullptr) || cmp(*first, *m_leftmost)) {
+            m_leftmost = first;
+        }
+        if ((m_rightmost == nullptr) || !cmp(*last, *m_rightmost)) {
+            m_rightmost = last;
+        }
+    }
+
+    // TODO: need a macro for the msvc.
+    [[no_unique_address]]
+    detail::comparator<CMP> cmp;
+    np_t m_leftmost;
+    np_t m_rightmost;
+};
 } // namespace uit
 #endif // irwbt.hpp
\ No newline at end of file
@@ -43,6 +43,18 @@ class isdlist<Right, Left> {
         m_right = nullptr;
     }
 
+    // The disposer is called on each node from front to back, it may free the node.
+    template <typename Disposer>
+    void clear_and_dispose(Disposer&& disposer) {
+        T* cur = m_right;
+        clear();
+        while (cur != nullptr) {
+            T* next = cur->*Right;
+            disposer(cur);
+            cur = next;
+        }
+    }
+
     [[nodiscard]]
     T& front() const noexcept {
         return *m_right;
@@ -80,6 +92,26 @@ class isdlist<Right, Left> {
         return right;
     }
 
+    // Move all nodes of the other list to the front of this list, the other list must not be this
+    // one and it becomes empty. There's no tail, so it's O(m) for the m nodes of the other list.
+    void splice_front(isdlist& other) noexcept {
+        T* first = other.m_right;
+        if (first == nullptr) [[unlikely]] {
+            return;
+        }
+        T* last = first;
+        while (last->*Right != nullptr) {
+            last = last->*Right;
+        }
+        last->*Right = m_right;
+        if (m_right != nullptr) {
+            m_right->*Left = last;
+        }
+        first->*Left = mock_head();
+        m_right = first;
+        other.clear();
+    }
+
     template <typename T_CV>
     struct iterator_t {
         using iterator_category = std::forward_iterator_tag;
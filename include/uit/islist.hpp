@@ -45,6 +45,19 @@ class islist<Right> {
         m_right = nullptr;
     }
 
+    // The disposer is called on each node from front to back, it may free the node, since the next
+    // node is read before.
+    template <typename Disposer>
+    void clear_and_dispose(Disposer&& disposer) {
+        T* cur = m_right;
+        clear();
+        while (cur != nullptr) {
+            T* next = cur->*Right;
+            disposer(cur);
+            cur = next;
+        }
+    }
+
     [[nodiscard]]
     T& front() const noexcept {
         return *m_right;
@@ -77,6 +90,22 @@ class islist<Right> {
         return nullptr;
     }
 
+    // Move all nodes of the other list to the front of this list, the other list must not be this
+    // one and it becomes empty. There's no tail, so it's O(m) for the m nodes of the other list.
+    void splice_front(islist& other) noexcept {
+        T* first = other.m_right;
+        if (first == nullptr) [[unlikely]] {
+            return;
+        }
+        T* last = first;
+        while (last->*Right != nullptr) {
+            last = last->*Right;
+        }
+        last->*Right = m_right;
+        m_right = first;
+        other.clear();
+    }
+
     template <typename T_CV>
     struct iterator_t {
         using iterator_category = std::forward_iterator_tag;
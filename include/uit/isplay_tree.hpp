@@ -0,0 +1,234 @@
+// SPDX-FileCopyrightText: 2025 TypeCombinator <typecombinator@foxmail.com>
+//
+// SPDX-License-Identifier: BSD 3-Clause
+
+#ifndef UIT_ISPLAY_TREE_6A2E0F93_D1B4_4C57_8E3A_95B7C1F04D28
+#define UIT_ISPLAY_TREE_6A2E0F93_D1B4_4C57_8E3A_95B7C1F04D28
+#include <uit/intrusive.hpp>
+#include <uit/detail/comparator.hpp>
+#include <cstddef>
+#include <functional>
+
+// References:
+// [0] Daniel Dominic Sleator and Robert Endre Tarjan. Self-Adjusting Binary Search Trees. 1985.
+// Notices:
+// [0] The acronym isplay_tree stands for intrusive splay tree.
+// [1] This implementation doesn't use mock_sentinel, the empty child is nullptr, it's safe for use.
+// [2] The splaying is top-down, so neither parent pointers nor recursion is required. The left and
+// right trees of the splaying are assembled by the pointers to their open links, instead of the
+// header node of [0], which can't be constructed for an intrusive node.
+// [3] Lookups splay the found node to the root, so they modify the tree, and they're not const. A
+// tree may degenerate into a list, all operations are amortized O(log n).
+namespace uit {
+template <auto Right, auto Left, typename CMP = std::less<>>
+struct isplay_tree;
+
+template <typename T, typename MT, MT T::*Right, MT T::*Left, typename CMP>
+struct isplay_tree<Right, Left, CMP> {
+   public:
+    using np_t = T *;
+
+    isplay_tree() noexcept
+        : m_head{nullptr}
+        , m_size{0} {
+    }
+
+    [[nodiscard]]
+    bool empty() const noexcept {
+        return m_head == nullptr;
+    }
+
+    void clear() noexcept {
+        m_head = nullptr;
+        m_size = 0;
+    }
+
+    // The disposer is called on each node in order, it may free the node. It's a stackless walk that
+    // rotates the left child up until there is none, just like boost.intrusive does.
+    template <typename Disposer>
+    void clear_and_dispose(Disposer &&disposer) {
+        np_t cur = m_head;
+        clear();
+        while (cur != nullptr) {
+            np_t left = cur->*Left;
+            if (left != nullptr) {
+                cur->*Left = left->*Right;
+                left->*Right = cur;
+                cur = left;
+            } else {
+                np_t right = cur->*Right;
+                disposer(cur);
+                cur = right;
+            }
+        }
+    }
+
+    [[nodiscard]]
+    std::size_t size() const noexcept {
+        return m_size;
+    }
+
+    void insert_multi(np_t node) noexcept {
+        m_size++;
+        if (m_head == nullptr) [[unlikely]] {
+            node->*Right = nullptr;
+            node->*Left = nullptr;
+            m_head = node;
+            return;
+        }
+        np_t root = splay_key(m_head, *node);
+        link_root(root, node);
+    }
+
+    // insert unique
+    bool insert(np_t node) noexcept {
+        if (m_head == nullptr) [[unlikely]] {
+            node->*Right = nullptr;
+            node->*Left = nullptr;
+            m_head = node;
+            m_size++;
+            return true;
+        }
+        np_t root = splay_key(m_head, *node);
+        if (cmp.compare(*node, *root) == 0) {
+            m_head = root;
+            return false;
+        }
+        link_root(root, node);
+        m_size++;
+        return true;
+    }
+
+    // Returns the found node and splays it to the root.
+    template <typename K>
+    [[nodiscard]]
+    np_t find(const K &key) noexcept {
+        if (m_head == nullptr) [[unlikely]] {
+            return nullptr;
+        }
+        m_head = splay_key(m_head, key);
+        if (cmp.compare(key, *m_head) != 0) {
+            return nullptr;
+        }
+        return m_head;
+    }
+
+    // It's UB when the tree is empty, so you must check for emptiness before calling this function.
+    np_t remove_leftmost() noexcept {
+        np_t root = splay(m_head, [](const T &) { return -1; });
+        m_head = root->*Right;
+        m_size--;
+        return root;
+    }
+
+    template <typename K>
+    np_t remove(const K &key) noexcept {
+        if (m_head == nullptr) [[unlikely]] {
+            return nullptr;
+        }
+        np_t root = splay_key(m_head, key);
+        if (cmp.compare(key, *root) != 0) {
+            m_head = root;
+            return nullptr;
+        }
+        if (root->*Left == nullptr) {
+            m_head = root->*Right;
+        } else {
+            // The rightmost node of the left subtree has no right child after splaying.
+            m_head = splay(root->*Left, [](const T &) { return 1; });
+            m_head->*Right = root->*Right;
+        }
+        m_size--;
+        return root;
+    }
+   private:
+    template <typename K>
+    np_t splay_key(np_t root, const K &key) noexcept {
+        return splay(root, [this, &key](const T &node) {
+            auto order = cmp.compare(key, node);
+            if (order < 0) {
+                return -1;
+            }
+            return (order > 0) ? 1 : 0;
+        });
+    }
+
+    // Splay the last node on the path toward "dir" to the root of the subtree. "dir" returns a
+    // negative number to go left, a positive number to go right, and 0 to stop.
+    template <typename Dir>
+    static np_t splay(np_t cur, Dir dir) noexcept {
+        np_t left_tree = nullptr;
+        np_t right_tree = nullptr;
+        // The open links of the max node in the left tree and the min node in the right tree.
+        np_t *left_link = &left_tree;
+        np_t *right_link = &right_tree;
+        while (1) {
+            int d = dir(*cur);
+            if (d < 0) {
+                np_t left = cur->*Left;
+                if (left == nullptr) {
+                    break;
+                }
+                if (dir(*left) < 0) { // zig-zig, rotate right
+                    cur->*Left = left->*Right;
+                    left->*Right = cur;
+                    cur = left;
+                    if (cur->*Left == nullptr) {
+                        break;
+                    }
+                }
+                // Link the current node to the right tree.
+                *right_link = cur;
+                right_link = &(cur->*Left);
+                cur = cur->*Left;
+            } else if (d > 0) {
+                np_t right = cur->*Right;
+                if (right == nullptr) {
+                    break;
+                }
+                if (dir(*right) > 0) { // zig-zig, rotate left
+                    cur->*Right = right->*Left;
+                    right->*Left = cur;
+                    cur = right;
+                    if (cur->*Right == nullptr) {
+                        break;
+                    }
+                }
+                // Link the current node to the left tree.
+                *left_link = cur;
+                left_link = &(cur->*Right);
+                cur = cur->*Right;
+            } else {
+                break;
+            }
+        }
+        *left_link = cur->*Left;
+        *right_link = cur->*Right;
+        cur->*Left = left_tree;
+        cur->*Right = right_tree;
+        return cur;
+    }
+
+    // The root is the splayed neighbor of the node, the node becomes the new root. Equivalent nodes
+    // go right.
+    void link_root(np_t root, np_t node) noexcept {
+        if (cmp(*node, *root)) {
+            node->*Left = root->*Left;
+            node->*Right = root;
+            root->*Left = nullptr;
+        } else {
+            node->*Right = root->*Right;
+            node->*Left = root;
+            root->*Right = nullptr;
+        }
+        m_head = node;
+    }
+
+    // TODO: need a macro for the msvc.
+    [[no_unique_address]]
+    detail::comparator<CMP> cmp;
+    T *m_head;
+    std::size_t m_size;
+};
+} // namespace uit
+#endif // isplay_tree.hpp
@@ -0,0 +1,363 @@
+// SPDX-FileCopyrightText: 2025 TypeCombinator <typecombinator@foxmail.com>
+//
+// SPDX-License-Identifier: BSD 3-Clause
+
+#ifndef UIT_IZIP_TREE_9D41B6E2_3C7F_4A08_B5E1_72F0C84A1D36
+#define UIT_IZIP_TREE_9D41B6E2_3C7F_4A08_B5E1_72F0C84A1D36
+#include <uit/intrusive.hpp>
+#include <uit/detail/comparator.hpp>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <type_traits>
+
+// References:
+// [0] Robert E. Tarjan, Caleb C. Levy, and Stephen Timmel. Zip Trees. 2019.
+// Notices:
+// [0] The acronym izip_tree stands for intrusive zip tree.
+// [1] The mock sentinel will involve UB, but the code works correctly.
+// [2] The rank of a node is a geometric random number, the rank of the sentinel is 0. Ties are
+// broken by keys, so the rank of a left child is less than the rank of its parent, and the rank of
+// a right child isn't greater than the rank of its parent.
+// [3] There is no rotation. The insertion unzips the path below the new node, and the removal zips
+// the two spines of the removed node, both are iterative.
+// [4] The Size is optional, it's only required by the order statistics, pass nullptr to disable
+// it.
+namespace uit {
+template <auto Right, auto Left, auto Rank, typename CMP = std::less<>, auto Size = nullptr>
+struct izip_tree;
+
+template <typename T, typename MT, MT T::*Right, MT T::*Left, auto Rank, typename CMP, auto Size>
+struct izip_tree<Right, Left, Rank, CMP, Size> {
+   public:
+    using np_t = T *;
+    using cnp_t = const T *;
+    using rank_t = uit::member_t<Rank>;
+
+    static constexpr bool has_size = !std::is_same_v<decltype(Size), std::nullptr_t>;
+
+    izip_tree() noexcept
+        : m_head{mock_sentinel()}
+        , m_size{0}
+        , m_seed{0x9e3779b97f4a7c15} {
+    }
+
+    // The seed must not be 0.
+    explicit izip_tree(std::uint64_t seed) noexcept
+        : m_head{mock_sentinel()}
+        , m_size{0}
+        , m_seed{seed} {
+    }
+
+    [[nodiscard]]
+    static bool is_sentinel(const T *node) noexcept {
+        return node == const_mock_sentinel();
+    }
+
+    [[nodiscard]]
+    bool empty() const noexcept {
+        return is_sentinel(m_head);
+    }
+
+    void clear() noexcept {
+        m_head = mock_sentinel();
+        m_size = 0;
+    }
+
+    // The disposer is called on each node in order, it may free the node. It's stackless, the left
+    // child is rotated up until there is none before the node is disposed.
+    template <typename Disposer>
+    void clear_and_dispose(Disposer &&disposer) {
+        np_t cur = m_head;
+        clear();
+        while (!is_sentinel(cur)) {
+            np_t left = cur->*Left;
+            if (!is_sentinel(left)) {
+                cur->*Left = left->*Right;
+                left->*Right = cur;
+                cur = left;
+            } else {
+                np_t right = cur->*Right;
+                disposer(cur);
+                cur = right;
+            }
+        }
+    }
+
+    [[nodiscard]]
+    std::size_t size() const noexcept {
+        return m_size;
+    }
+
+    void insert_multi(np_t node) noexcept {
+        rank_t rank = random_rank();
+        node->*Rank = rank;
+        np_t *cur_ptr = &m_head;
+        np_t cur = m_head;
+        // Equivalent nodes go right, so the new node stays below them when the ranks are equal.
+        while ((cur->*Rank > rank) || ((cur->*Rank == rank) && !cmp(*node, *cur))) {
+            if constexpr (has_size) {
+                cur->*Size += 1;
+            }
+            cur_ptr = cmp(*node, *cur) ? &(cur->*Left) : &(cur->*Right);
+            cur = *cur_ptr;
+        }
+        *cur_ptr = node;
+        if constexpr (has_size) {
+            node->*Size = cur->*Size + 1;
+        }
+        unzip(node, cur);
+        m_size++;
+    }
+
+    // insert unique
+    bool insert(np_t node) noexcept {
+        if (find(*node) != nullptr) {
+            return false;
+        }
+        insert_multi(node);
+        return true;
+    }
+
+    // It's UB when the tree is empty, so you must check for emptiness before calling this function.
+    np_t remove_leftmost() noexcept {
+        np_t *cur_ptr = &m_head;
+        np_t cur = m_head;
+        while (!is_sentinel(cur->*Left)) {
+            if constexpr (has_size) {
+                cur->*Size -= 1;
+            }
+            cur_ptr = &(cur->*Left);
+            cur = *cur_ptr;
+        }
+        *cur_ptr = cur->*Right;
+        m_size--;
+        return cur;
+    }
+
+    template <typename K>
+    np_t remove(const K &key) noexcept {
+        np_t *cur_ptr = find_link(key);
+        if (cur_ptr == nullptr) {
+            return nullptr;
+        }
+        np_t node = *cur_ptr;
+        if constexpr (has_size) {
+            // The same path is walked again, since the sizes can't be updated before the node is
+            // known to exist.
+            np_t cur = m_head;
+            while (cur != node) {
+                cur->*Size -= 1;
+                cur = cmp(key, *cur) ? cur->*Left : cur->*Right;
+            }
+        }
+        zip(cur_ptr, node->*Left, node->*Right);
+        m_size--;
+        return node;
+    }
+
+    template <typename K>
+    [[nodiscard]]
+    np_t find(const K &key) const noexcept {
+        cnp_t cur = m_head;
+        while (!is_sentinel(cur)) {
+            auto order = cmp.compare(key, *cur);
+            if (order < 0) {
+                cur = cur->*Left;
+            } else if (order > 0) {
+                cur = cur->*Right;
+            } else {
+                return const_cast<np_t>(cur);
+            }
+        }
+        return nullptr;
+    }
+
+    // Returns the node whose rank in order is "index", it starts from 0.
+    [[nodiscard]]
+    np_t at(std::size_t index) const noexcept
+        requires has_size
+    {
+        cnp_t cur = m_head;
+        while (!is_sentinel(cur)) {
+            std::size_t left_size = cur->*Left->*Size;
+            if (index < left_size) {
+                cur = cur->*Left;
+            } else if (index > left_size) {
+                index -= left_size + 1;
+                cur = cur->*Right;
+            } else {
+                return const_cast<np_t>(cur);
+            }
+        }
+        return nullptr;
+    }
+
+    [[nodiscard]]
+    std::size_t height() const noexcept {
+        return height_impl(m_head);
+    }
+
+    static bool validate_sentinel() noexcept {
+        auto s = const_mock_sentinel();
+        if constexpr (has_size) {
+            if (s->*Size != 0) {
+                return false;
+            }
+        }
+        return (s->*Right == s) && (s->*Left == s) && (s->*Rank == 0);
+    }
+   private:
+    // A geometric random number in [1, max], drawn from a xorshift64* generator.
+    rank_t random_rank() noexcept {
+        m_seed ^= m_seed >> 12;
+        m_seed ^= m_seed << 25;
+        m_seed ^= m_seed >> 27;
+        std::uint64_t bits = m_seed * 0x2545f4914f6cdd1d;
+        constexpr std::uint64_t max = std::numeric_limits<rank_t>::max();
+        std::uint64_t rank = static_cast<std::uint64_t>(std::countr_zero(bits)) + 1;
+        return static_cast<rank_t>(rank < max ? rank : max);
+    }
+
+    template <typename K>
+    np_t *find_link(const K &key) noexcept {
+        np_t *cur_ptr = &m_head;
+        np_t cur = m_head;
+        while (!is_sentinel(cur)) {
+            auto order = cmp.compare(key, *cur);
+            if (order < 0) {
+                cur_ptr = &(cur->*Left);
+            } else if (order > 0) {
+                cur_ptr = &(cur->*Right);
+            } else {
+                return cur_ptr;
+            }
+            cur = *cur_ptr;
+        }
+        return nullptr;
+    }
+
+    // Split the subtree rooted at "cur" by the node, the smaller part is linked as the left child of
+    // the node, the other part is linked as the right child.
+    void unzip(np_t node, np_t cur) noexcept {
+        np_t *left_ptr = &(node->*Left);
+        np_t *right_ptr = &(node->*Right);
+        std::size_t left_size = 0;
+        std::size_t right_size = 0;
+        while (!is_sentinel(cur)) {
+            if (cmp(*node, *cur)) {
+                if constexpr (has_size) {
+                    right_size += cur->*Right->*Size + 1;
+                }
+                *right_ptr = cur;
+                right_ptr = &(cur->*Left);
+                cur = *right_ptr;
+            } else {
+                if constexpr (has_size) {
+                    left_size += cur->*Left->*Size + 1;
+                }
+                *left_ptr = cur;
+                left_ptr = &(cur->*Right);
+                cur = *left_ptr;
+            }
+        }
+        *left_ptr = mock_sentinel();
+        *right_ptr = mock_sentinel();
+        if constexpr (has_size) {
+            // The totals of both parts are known now, so the sizes of the spines are fixed top-down.
+            for (np_t i = node->*Left; !is_sentinel(i); i = i->*Right) {
+                std::size_t next = left_size - i->*Left->*Size - 1;
+                i->*Size = left_size;
+                left_size = next;
+            }
+            for (np_t i = node->*Right; !is_sentinel(i); i = i->*Left) {
+                std::size_t next = right_size - i->*Right->*Size - 1;
+                i->*Size = right_size;
+                right_size = next;
+            }
+        }
+    }
+
+    // Merge the right spine of "left" and the left spine of "right" by ranks, and link the result to
+    // "*cur_ptr". All nodes in "left" are not greater than those in "right".
+    static void zip(np_t *cur_ptr, np_t left, np_t right) noexcept {
+        while (1) {
+            if (is_sentinel(left)) {
+                *cur_ptr = right;
+                return;
+            }
+            if (is_sentinel(right)) {
+                *cur_ptr = left;
+                return;
+            }
+            // The left one wins the tie, since it's smaller.
+            if (left->*Rank >= right->*Rank) {
+                if constexpr (has_size) {
+                    left->*Size += right->*Size;
+                }
+                *cur_ptr = left;
+                cur_ptr = &(left->*Right);
+                left = left->*Right;
+            } else {
+                if constexpr (has_size) {
+                    right->*Size += left->*Size;
+                }
+                *cur_ptr = right;
+                cur_ptr = &(right->*Left);
+                right = right->*Left;
+            }
+        }
+    }
+
+    [[nodiscard]]
+    static std::size_t height_impl(const T *root) noexcept {
+        if (is_sentinel(root)) {
+            return 0;
+        }
+        std::size_t left_height = height_impl(root->*Left);
+        std::size_t right_height = height_impl(root->*Right);
+        return (left_height > right_height ? left_height : right_height) + 1;
+    }
+
+    union sentinel_t {
+        constexpr sentinel_t() noexcept {
+            // UB!!! The lifetime of storage has not yet started.
+            storage.*Right = &storage;
+            storage.*Left = &storage;
+            storage.*Rank = 0;
+            if constexpr (has_size) {
+                storage.*Size = 0;
+            }
+        }
+
+        // The storage is never constructed, so it must not be destroyed, T may have non-trivial
+        // members such as std::string.
+        constexpr ~sentinel_t() {
+        }
+
+        T storage;
+        unsigned char buffer[sizeof(T)];
+    };
+
+    // It's a fixed point!
+    static inline const sentinel_t sentinel{};
+
+    static T *mock_sentinel() noexcept {
+        return const_cast<T *>(&sentinel.storage);
+    }
+
+    static const T *const_mock_sentinel() noexcept {
+        return &sentinel.storage;
+    }
+
+    // TODO: need a macro for the msvc.
+    [[no_unique_address]]
+    detail::comparator<CMP> cmp;
+    T *m_head;
+    std::size_t m_size;
+    std::uint64_t m_seed;
+};
+} // namespace uit
+#endif // izip_tree.hpp
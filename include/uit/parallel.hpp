@@ -0,0 +1,104 @@
+// SPDX-FileCopyrightText: 2025 TypeCombinator <typecombinator@foxmail.com>
+//
+// SPDX-License-Identifier: BSD 3-Clause
+
+#ifndef UIT_PARALLEL_5E0A7C93_2B6D_4E18_8F41_C9D3A06B7E25
+#define UIT_PARALLEL_5E0A7C93_2B6D_4E18_8F41_C9D3A06B7E25
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <optional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Notices:
+// [0] The traversal of a tree with subtree sizes (irsbt, irwbt and their cached variants) is split
+// by rank into equal chunks, and each chunk is reached by one descent of for_each_range, so the
+// split doesn't scan the tree.
+// [1] The chunks are equal, so there's nothing to steal, one thread is started for each chunk and
+// the calling thread takes the first one. It's meant for large trees, the start of a thread costs
+// more than walking thousands of nodes.
+// [2] The tree must not be modified during the traversal, and F is called concurrently on distinct
+// nodes. The first exception thrown by a chunk is rethrown after all the chunks are joined.
+namespace uit {
+namespace detail {
+// Splits [0, size) into at most "threads" equal chunks, and calls chunk(i, first, last) for the
+// i-th one.
+template <typename Chunk>
+void parallel_chunks(std::size_t size, std::size_t threads, Chunk &&chunk) {
+    std::size_t n = std::min(std::max(threads, std::size_t{1}), size);
+    if (n <= 1) {
+        if (size > 0) {
+            chunk(std::size_t{0}, std::size_t{0}, size);
+        }
+        return;
+    }
+    std::vector<std::exception_ptr> errors(n);
+    std::vector<std::jthread> workers;
+    workers.reserve(n - 1);
+
+    auto run = [&chunk, &errors, size, n](std::size_t i) {
+        try {
+            chunk(i, size * i / n, size * (i + 1) / n);
+        } catch (...) {
+            errors[i] = std::current_exception();
+        }
+    };
+    for (std::size_t i = 1; i < n; i++) {
+        workers.emplace_back(run, i);
+    }
+    run(0);
+    workers.clear();
+    for (auto &e: errors) {
+        if (e) {
+            std::rethrow_exception(e);
+        }
+    }
+}
+} // namespace detail
+
+template <typename Tree, typename F>
+void parallel_for_each(
+    const Tree &tree,
+    F &&f,
+    std::size_t threads = std::thread::hardware_concurrency()) {
+    detail::parallel_chunks(
+        tree.size(), threads, [&tree, &f](std::size_t, std::size_t first, std::size_t last) {
+            tree.for_each_range(first, last, f);
+        });
+}
+
+// Map is called on each node, and the results are folded by Reduce in order, init is the leftmost
+// operand. Reduce must be associative, but it needn't be commutative.
+template <typename Tree, typename R, typename Reduce, typename Map>
+[[nodiscard]]
+R parallel_reduce(
+    const Tree &tree,
+    R init,
+    Reduce &&reduce,
+    Map &&map,
+    std::size_t threads = std::thread::hardware_concurrency()) {
+    std::size_t n = std::min(std::max(threads, std::size_t{1}), tree.size());
+    std::vector<std::optional<R>> partials(n);
+
+    detail::parallel_chunks(
+        tree.size(),
+        threads,
+        [&tree, &reduce, &map, &partials](std::size_t i, std::size_t first, std::size_t last) {
+            std::optional<R> &acc = partials[i];
+            tree.for_each_range(first, last, [&reduce, &map, &acc](auto &node) {
+                if (acc) [[likely]] {
+                    *acc = reduce(std::move(*acc), map(node));
+                } else {
+                    acc.emplace(map(node));
+                }
+            });
+        });
+    for (auto &p: partials) {
+        init = reduce(std::move(init), std::move(*p));
+    }
+    return init;
+}
+} // namespace uit
+#endif // parallel.hpp
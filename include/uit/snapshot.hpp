@@ -0,0 +1,138 @@
+// SPDX-FileCopyrightText: 2025 TypeCombinator <typecombinator@foxmail.com>
+//
+// SPDX-License-Identifier: BSD 3-Clause
+
+#ifndef UIT_SNAPSHOT_0B8F1C2E_6D4A_4F3B_9A57_E21C7D5B3F60
+#define UIT_SNAPSHOT_0B8F1C2E_6D4A_4F3B_9A57_E21C7D5B3F60
+#include <uit/intrusive.hpp>
+#include <bit>
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+// References:
+// [0] Paul-Virak Khuong and Pat Morin. Array Layouts for Comparison-Based Searching. 2017.
+// Notices:
+// [0] A snapshot is a read-only index of keys and node pointers in the Eytzinger (BFS) layout, it's
+// built by walking a tree (irsbt or irwbt) once.
+// [1] The snapshot isn't updated along with the tree, it must be rebuilt after the tree is
+// modified, and the nodes must outlive the snapshot.
+// [2] The descent is branchless, and the cache line of the descendants a few levels below is
+// prefetched at each level.
+namespace uit {
+template <auto Key, typename CMP = std::less<>>
+class eytzinger_snapshot;
+
+template <typename T, typename MT, MT T::*Key, typename CMP>
+class eytzinger_snapshot<Key, CMP> {
+   public:
+    using np_t = T *;
+    using key_t = MT;
+
+    eytzinger_snapshot() = default;
+
+    template <typename Tree>
+    explicit eytzinger_snapshot(const Tree &tree) {
+        rebuild(tree);
+    }
+
+    // Regenerate the snapshot from the tree, it's O(n) since the tree is already sorted.
+    template <typename Tree>
+    void rebuild(const Tree &tree) {
+        std::size_t n = tree.size();
+        // The index 0 is unused, and m_nodes[0] is nullptr for the "not found" result.
+        m_keys.resize(n + 1);
+        m_nodes.assign(n + 1, nullptr);
+        if (n == 0) [[unlikely]] {
+            return;
+        }
+        std::size_t i = leftmost_index(1, n);
+        tree.for_each([this, &i, n](T &node) {
+            m_keys[i] = node.*Key;
+            m_nodes[i] = &node;
+            i = next_index(i, n);
+        });
+    }
+
+    void clear() noexcept {
+        m_keys.clear();
+        m_nodes.clear();
+    }
+
+    [[nodiscard]]
+    bool empty() const noexcept {
+        return size() == 0;
+    }
+
+    [[nodiscard]]
+    std::size_t size() const noexcept {
+        return m_nodes.empty() ? 0 : m_nodes.size() - 1;
+    }
+
+    // Returns the first node whose key is not less than k, or nullptr if there is no such node.
+    template <typename K>
+    [[nodiscard]]
+    np_t lower_bound(const K &k) const noexcept {
+        return m_nodes.empty() ? nullptr : m_nodes[lower_bound_index(k)];
+    }
+
+    template <typename K>
+    [[nodiscard]]
+    np_t find(const K &k) const noexcept {
+        if (m_nodes.empty()) [[unlikely]] {
+            return nullptr;
+        }
+        std::size_t i = lower_bound_index(k);
+        if ((i == 0) || cmp(k, m_keys[i])) {
+            return nullptr;
+        }
+        return m_nodes[i];
+    }
+   private:
+    // The number of keys in a cache line. The descendants of a node "log2(prefetch_stride)" levels
+    // below are adjacent, so they're prefetched together.
+    static constexpr std::size_t prefetch_stride =
+        (64 / sizeof(key_t)) > 0 ? (64 / sizeof(key_t)) : 1;
+
+    template <typename K>
+    std::size_t lower_bound_index(const K &k) const noexcept {
+        const key_t *keys = m_keys.data();
+        std::size_t n = m_keys.size() - 1;
+        std::size_t i = 1;
+        while (i <= n) {
+            __builtin_prefetch(keys + i * prefetch_stride);
+            i = 2 * i + static_cast<std::size_t>(cmp(keys[i], k));
+        }
+        // Cancel the trailing right turns and the last left turn.
+        return i >> (std::countr_one(i) + 1);
+    }
+
+    static std::size_t leftmost_index(std::size_t i, std::size_t n) noexcept {
+        while (2 * i <= n) {
+            i = 2 * i;
+        }
+        return i;
+    }
+
+    // The in-order successor in the implicit tree.
+    static std::size_t next_index(std::size_t i, std::size_t n) noexcept {
+        if (2 * i + 1 <= n) {
+            return leftmost_index(2 * i + 1, n);
+        }
+        return i >> (std::countr_one(i) + 1);
+    }
+
+    // TODO: need a macro for the msvc.
+    [[no_unique_address]]
+    CMP cmp;
+    std::vector<key_t> m_keys;
+    std::vector<np_t> m_nodes;
+};
+
+template <auto Key, typename CMP = std::less<>, typename Tree>
+[[nodiscard]]
+eytzinger_snapshot<Key, CMP> snapshot(const Tree &tree) {
+    return eytzinger_snapshot<Key, CMP>{tree};
+}
+} // namespace uit
+#endif // snapshot.hpp
@@ -0,0 +1,122 @@
+// SPDX-FileCopyrightText: 2025 TypeCombinator <typecombinator@foxmail.com>
+//
+// SPDX-License-Identifier: BSD 3-Clause
+
+#ifndef UIT_WBT_BALANCE_8C1D5E27_4B93_4F0A_A6E8_2D7F91B3C045
+#define UIT_WBT_BALANCE_8C1D5E27_4B93_4F0A_A6E8_2D7F91B3C045
+#include <cstddef>
+#include <cstdint>
+#include <ratio>
+
+// References:
+// [0] Yoichi Hirai and Kazuhiko Yamamoto. Balancing weight-balanced trees. 2011.
+// Notices:
+// [0] The balance parameters of irwbt and irsbt. A node is too heavy on one side when
+// "heavy > light * DELTA + 1", and it's fixed by a double rotation when the outer grandchild is
+// light, that is "outer * GAMMA < inner + 1", otherwise by a single rotation. The sizes are the
+// numbers of nodes.
+// [1] Both parameters are rational, so the legal region of [0] can be explored. The default <3, 2>
+// is the only integral pair in the region.
+// [2] The legality is checked at compile time by exhausting all subtrees up to 48 nodes, but only
+// for the bottom-up model of [0]: a node with balanced children becomes unbalanced by one insertion
+// or removal, and the single or double rotation chosen by GAMMA must balance it again. It's not a
+// proof, on a grid of quarters it agrees with the same search up to 90 nodes. The top-down
+// rebalancing of irwbt and the rebuilding of push_back_max, insert_batch, merge and join aren't
+// modeled, they're covered by the unit tests of every legal pair on that grid.
+namespace uit {
+namespace detail {
+template <std::uintmax_t DN, std::uintmax_t DD, std::uintmax_t GN, std::uintmax_t GD>
+struct wbt_balance_checker {
+    static constexpr bool is_heavy(std::uintmax_t light, std::uintmax_t heavy) noexcept {
+        return light * DN + DD < heavy * DD;
+    }
+
+    static constexpr bool is_balanced(std::uintmax_t a, std::uintmax_t b) noexcept {
+        return !is_heavy(a, b) && !is_heavy(b, a);
+    }
+
+    static constexpr bool is_double(std::uintmax_t inner, std::uintmax_t outer) noexcept {
+        return outer * GN < (inner + 1) * GD;
+    }
+
+    // The left subtree has "l" nodes, the right one has "r" nodes and it's too heavy.
+    static constexpr bool can_fix(std::uintmax_t l, std::uintmax_t r) noexcept {
+        for (std::uintmax_t rl = 0; rl < r; rl++) {
+            std::uintmax_t rr = r - 1 - rl;
+            if (!is_balanced(rl, rr)) {
+                continue;
+            }
+            if (!is_double(rl, rr)) {
+                if (!is_balanced(l, rl) || !is_balanced(l + rl + 1, rr)) {
+                    return false;
+                }
+                continue;
+            }
+            if (rl == 0) {
+                return false;
+            }
+            for (std::uintmax_t rll = 0; rll < rl; rll++) {
+                std::uintmax_t rlr = rl - 1 - rll;
+                if (!is_balanced(rll, rlr)) {
+                    continue;
+                }
+                if (!is_balanced(l, rll) || !is_balanced(rlr, rr)
+                    || !is_balanced(l + rll + 1, rlr + rr + 1)) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    static constexpr bool is_legal() noexcept {
+        constexpr std::uintmax_t max = 48;
+        for (std::uintmax_t l = 0; l < max; l++) {
+            for (std::uintmax_t r = 0; r < max; r++) {
+                if (!is_balanced(l, r)) {
+                    continue;
+                }
+                // Insert into the right subtree.
+                if (is_heavy(l, r + 1) && !can_fix(l, r + 1)) {
+                    return false;
+                }
+                // Remove from the left subtree.
+                if ((l > 0) && is_heavy(l - 1, r) && !can_fix(l - 1, r)) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+};
+} // namespace detail
+
+template <typename Delta = std::ratio<3>, typename Gamma = std::ratio<2>>
+struct wbt_balance {
+    static constexpr std::uintmax_t delta_num = Delta::num;
+    static constexpr std::uintmax_t delta_den = Delta::den;
+    static constexpr std::uintmax_t gamma_num = Gamma::num;
+    static constexpr std::uintmax_t gamma_den = Gamma::den;
+
+    static_assert((Delta::num > 0) && (Gamma::num > 0), "DELTA and GAMMA must be positive.");
+    static_assert(
+        detail::wbt_balance_checker<delta_num, delta_den, gamma_num, gamma_den>::is_legal(),
+        "<DELTA, GAMMA> is out of the legal region, see Hirai and Yamamoto.");
+
+    // Returns true if the subtree with "heavy" nodes is too heavy for its sibling.
+    template <typename S>
+    static constexpr bool is_heavy(S light, S heavy) noexcept {
+        return static_cast<std::uintmax_t>(light) * delta_num + delta_den
+            < static_cast<std::uintmax_t>(heavy) * delta_den;
+    }
+
+    // Returns true if the heavy child must be rotated first, the inner and the outer are the
+    // children of the heavy child.
+    template <typename S>
+    static constexpr bool is_double(S inner, S outer) noexcept {
+        return static_cast<std::uintmax_t>(outer) * gamma_num
+            < (static_cast<std::uintmax_t>(inner) + 1) * gamma_den;
+    }
+};
+} // namespace uit
+#endif // wbt_balance.hpp
@@ -3,9 +3,45 @@
 // SPDX-License-Identifier: BSD 3-Clause
 
 #pragma once
+#include <compare>
 #include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
 #include <uit/intrusive.hpp>
 
+struct list_apple {
+    explicit list_apple(uint64_t weight, int sn) noexcept
+        : weight(weight)
+        , sn(sn) {
+    }
+
+    uint64_t weight;
+    list_apple *right;
+    list_apple *left;
+    int sn;
+};
+
+// The node of all heaps, irheap links it by right and left, the pairing heap links its first child
+// by left, its next sibling by right and its previous sibling or parent by prev.
+struct heap_apple {
+    explicit heap_apple(uint64_t weight, int sn) noexcept
+        : weight(weight)
+        , sn(sn) {
+    }
+
+    bool operator<(const heap_apple &other) const noexcept {
+        return weight < other.weight;
+    }
+
+    uint64_t weight;
+    heap_apple *right;
+    heap_apple *left;
+    heap_apple *prev;
+    uint32_t index;
+    int sn;
+};
+
 struct rsbt_apple {
     explicit rsbt_apple(uint64_t weight, int sn) noexcept
         : weight(weight)
@@ -29,4 +65,95 @@ struct rsbt_apple {
     rsbt_apple *left;
     size_t size;
     int sn;
+};
+
+struct rbt_apple {
+    explicit rbt_apple(uint64_t weight, int sn) noexcept
+        : weight(weight)
+        , sn(sn) {
+    }
+
+    bool operator<(const rbt_apple &other) const noexcept {
+        return weight < other.weight;
+    }
+
+    bool operator<(uint64_t other_weight) const noexcept {
+        return weight < other_weight;
+    }
+
+    friend bool operator<(uint64_t other_weight, const rbt_apple &self) noexcept {
+        return other_weight < self.weight;
+    }
+
+    uint64_t weight;
+    rbt_apple *right;
+    rbt_apple *left;
+    rbt_apple *parent;
+    uint8_t color;
+    int sn;
+};
+
+struct zip_apple {
+    explicit zip_apple(uint64_t weight, int sn) noexcept
+        : weight(weight)
+        , sn(sn) {
+    }
+
+    bool operator<(const zip_apple &other) const noexcept {
+        return weight < other.weight;
+    }
+
+    bool operator<(uint64_t other_weight) const noexcept {
+        return weight < other_weight;
+    }
+
+    friend bool operator<(uint64_t other_weight, const zip_apple &self) noexcept {
+        return other_weight < self.weight;
+    }
+
+    uint64_t weight;
+    zip_apple *right;
+    zip_apple *left;
+    size_t size;
+    uint8_t rank;
+    int sn;
+};
+
+struct str_apple {
+    explicit str_apple(std::string name, int sn) noexcept
+        : name(std::move(name))
+        , sn(sn) {
+    }
+
+    friend bool operator==(const str_apple &a, const str_apple &b) noexcept {
+        return a.name == b.name;
+    }
+
+    friend std::strong_ordering operator<=>(const str_apple &a, const str_apple &b) noexcept {
+        return a.name <=> b.name;
+    }
+
+    std::string name;
+    str_apple *right;
+    str_apple *left;
+    size_t size;
+    int sn;
+};
+
+// A three-way comparator of the names, nodes can be compared with std::string_view.
+struct str_apple_compare {
+    using is_transparent = void;
+
+    static std::string_view key(const str_apple &apple) noexcept {
+        return apple.name;
+    }
+
+    static std::string_view key(std::string_view name) noexcept {
+        return name;
+    }
+
+    template <typename A, typename B>
+    std::strong_ordering operator()(const A &a, const B &b) const noexcept {
+        return key(a) <=> key(b);
+    }
 };
\ No newline at end of file
@@ -0,0 +1,160 @@
+// SPDX-FileCopyrightText: 2025 TypeCombinator <typecombinator@foxmail.com>
+//
+// SPDX-License-Identifier: BSD 3-Clause
+
+#pragma once
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define UIT_BENCH_HAS_RDTSC 1
+#endif
+
+// The clock of the latency, it's the TSC fenced by lfence on x86, so an operation can't overlap
+// with the reads, otherwise it's std::chrono::steady_clock. The ticks are converted to nanoseconds
+// by a calibration against steady_clock, and the cost of reading the clock is subtracted.
+class latency_clock {
+   public:
+    static uint64_t now() noexcept {
+#ifdef UIT_BENCH_HAS_RDTSC
+        _mm_lfence();
+        uint64_t t = __rdtsc();
+        _mm_lfence();
+        return t;
+#else
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+#endif
+    }
+
+    static const latency_clock &instance() {
+        static latency_clock clock;
+        return clock;
+    }
+
+    [[nodiscard]]
+    double ns_per_tick() const noexcept {
+        return m_ns_per_tick;
+    }
+
+    // The ticks of two back-to-back reads.
+    [[nodiscard]]
+    uint64_t overhead() const noexcept {
+        return m_overhead;
+    }
+   private:
+    latency_clock() {
+        m_overhead = UINT64_MAX;
+        for (int i = 0; i < 1024; i++) {
+            uint64_t t0 = now();
+            uint64_t t1 = now();
+            m_overhead = std::min(m_overhead, t1 - t0);
+        }
+#ifdef UIT_BENCH_HAS_RDTSC
+        auto begin = std::chrono::steady_clock::now();
+        uint64_t t0 = now();
+        while (std::chrono::steady_clock::now() - begin < std::chrono::milliseconds(20)) {
+        }
+        uint64_t t1 = now();
+        auto ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin);
+        m_ns_per_tick = ns.count() / static_cast<double>(t1 - t0);
+#else
+        m_ns_per_tick = 1.0;
+#endif
+    }
+
+    double m_ns_per_tick;
+    uint64_t m_overhead;
+};
+
+// A log-linear histogram of the latencies in ticks, like HdrHistogram. The values below 2^SubBits
+// are exact, above that each power of two is split into 2^(SubBits - 1) buckets, so the relative
+// error is below 2^(1 - SubBits), that is 1.6% for 7 bits.
+template <int SubBits = 7>
+class latency_histogram {
+    static constexpr uint64_t sub_count = uint64_t{1} << SubBits;
+    static constexpr uint64_t half_count = sub_count / 2;
+    static constexpr std::size_t bucket_count = sub_count + (64 - SubBits) * half_count;
+
+    static constexpr std::size_t index_of(uint64_t v) noexcept {
+        if (v < sub_count) {
+            return v;
+        }
+        int shift = std::bit_width(v) - SubBits;
+        return sub_count + (shift - 1) * half_count + ((v >> shift) - half_count);
+    }
+
+    // The largest value of the bucket.
+    static constexpr uint64_t value_of(std::size_t index) noexcept {
+        if (index < sub_count) {
+            return index;
+        }
+        int shift = static_cast<int>((index - sub_count) / half_count) + 1;
+        uint64_t sub = (index - sub_count) % half_count + half_count;
+        return ((sub + 1) << shift) - 1;
+    }
+   public:
+    latency_histogram()
+        : m_buckets(bucket_count)
+        , m_count{0}
+        , m_max{0} {
+    }
+
+    void record(uint64_t v) noexcept {
+        m_buckets[index_of(v)]++;
+        m_count++;
+        m_max = std::max(m_max, v);
+    }
+
+    // Times f and records its latency.
+    template <typename F>
+    void time(F &&f) {
+        uint64_t t0 = latency_clock::now();
+        f();
+        uint64_t t1 = latency_clock::now();
+        uint64_t overhead = latency_clock::instance().overhead();
+        record((t1 - t0) > overhead ? (t1 - t0 - overhead) : 0);
+    }
+
+    [[nodiscard]]
+    uint64_t count() const noexcept {
+        return m_count;
+    }
+
+    // The smallest recorded value that isn't less than the fraction q of the values, it's rounded
+    // up to the end of its bucket.
+    [[nodiscard]]
+    uint64_t quantile(double q) const noexcept {
+        auto rank = static_cast<uint64_t>(q * static_cast<double>(m_count) + 0.5);
+        rank = std::clamp<uint64_t>(rank, 1, m_count);
+        uint64_t seen = 0;
+        for (std::size_t i = 0; i < bucket_count; i++) {
+            seen += m_buckets[i];
+            if (seen >= rank) {
+                return std::min(value_of(i), m_max);
+            }
+        }
+        return m_max;
+    }
+
+    // Sets p50, p99, p99.9 and max in nanoseconds.
+    void report(benchmark::State &state) const {
+        if (m_count == 0) {
+            return;
+        }
+        double scale = latency_clock::instance().ns_per_tick();
+        state.counters["p50"] = static_cast<double>(quantile(0.5)) * scale;
+        state.counters["p99"] = static_cast<double>(quantile(0.99)) * scale;
+        state.counters["p99.9"] = static_cast<double>(quantile(0.999)) * scale;
+        state.counters["max"] = static_cast<double>(m_max) * scale;
+    }
+   private:
+    std::vector<uint64_t> m_buckets;
+    uint64_t m_count;
+    uint64_t m_max;
+};
@@ -0,0 +1,200 @@
+// SPDX-FileCopyrightText: 2025 TypeCombinator <typecombinator@foxmail.com>
+//
+// SPDX-License-Identifier: BSD 3-Clause
+
+#pragma once
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <cstdio>
+#if __has_include(<linux/perf_event.h>)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#define UIT_BENCH_HAS_PERF_EVENT 1
+#endif
+
+// The hardware counters of the calling thread by perf_event_open, only the user space is counted,
+// so it works without root when perf_event_paranoid is 2 or less. Each counter is opened alone, a
+// counter that isn't supported (e.g. L1D on some VMs) is skipped, and if none is available the
+// benchmarks are reported without them. The counts are scaled when the kernel multiplexes them.
+class perf_counters {
+   public:
+    struct event {
+        const char *name;
+        uint32_t type;
+        uint64_t config;
+    };
+
+    static constexpr int count = 4;
+
+#ifdef UIT_BENCH_HAS_PERF_EVENT
+    static constexpr event events[count] = {
+        {"insn", PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+        {"L1D-miss",
+         PERF_TYPE_HW_CACHE,
+         PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+             | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+        {"LLC-miss", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+        {"br-miss", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+    };
+#endif
+
+    static perf_counters &instance() {
+        static perf_counters counters;
+        return counters;
+    }
+
+    [[nodiscard]]
+    bool available() const noexcept {
+        for (int fd: m_fds) {
+            if (fd >= 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void reset() noexcept {
+        for (auto &v: m_values) {
+            v = 0;
+        }
+    }
+
+    void start() noexcept {
+#ifdef UIT_BENCH_HAS_PERF_EVENT
+        for (int i = 0; i < count; i++) {
+            if (m_fds[i] >= 0) {
+                read_raw(i, m_begin[i]);
+                ioctl(m_fds[i], PERF_EVENT_IOC_ENABLE, 0);
+            }
+        }
+#endif
+    }
+
+    // The counts since the last start() are added to the values.
+    void stop() noexcept {
+#ifdef UIT_BENCH_HAS_PERF_EVENT
+        for (int i = 0; i < count; i++) {
+            if (m_fds[i] >= 0) {
+                ioctl(m_fds[i], PERF_EVENT_IOC_DISABLE, 0);
+                raw_t end;
+                read_raw(i, end);
+                double delta = static_cast<double>(end.value - m_begin[i].value);
+                uint64_t enabled = end.enabled - m_begin[i].enabled;
+                uint64_t running = end.running - m_begin[i].running;
+                if ((running > 0) && (running < enabled)) {
+                    delta = delta * static_cast<double>(enabled) / static_cast<double>(running);
+                }
+                m_values[i] += delta;
+            }
+        }
+#endif
+    }
+
+    // Sets a user counter for each available event, the value is divided by "ops".
+    void report(benchmark::State &state, double ops) const {
+#ifdef UIT_BENCH_HAS_PERF_EVENT
+        for (int i = 0; i < count; i++) {
+            if (m_fds[i] >= 0) {
+                state.counters[events[i].name] = m_values[i] / ops;
+            }
+        }
+#endif
+    }
+
+    perf_counters(const perf_counters &) = delete;
+    perf_counters &operator=(const perf_counters &) = delete;
+   private:
+    struct raw_t {
+        uint64_t value;
+        uint64_t enabled;
+        uint64_t running;
+    };
+
+    perf_counters() {
+        for (int i = 0; i < count; i++) {
+            m_fds[i] = -1;
+            m_values[i] = 0;
+        }
+#ifdef UIT_BENCH_HAS_PERF_EVENT
+        for (int i = 0; i < count; i++) {
+            perf_event_attr attr{};
+            attr.size = sizeof(attr);
+            attr.type = events[i].type;
+            attr.config = events[i].config;
+            attr.disabled = 1;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+            m_fds[i] = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+        }
+#endif
+        if (!available()) {
+            std::fprintf(stderr, "***WARNING*** The hardware counters are unavailable.\n");
+        }
+    }
+
+    ~perf_counters() {
+#ifdef UIT_BENCH_HAS_PERF_EVENT
+        for (int fd: m_fds) {
+            if (fd >= 0) {
+                close(fd);
+            }
+        }
+#endif
+    }
+
+#ifdef UIT_BENCH_HAS_PERF_EVENT
+    void read_raw(int i, raw_t &raw) const noexcept {
+        if (read(m_fds[i], &raw, sizeof(raw)) != static_cast<ssize_t>(sizeof(raw))) {
+            raw = {};
+        }
+    }
+#endif
+
+    int m_fds[count];
+    double m_values[count];
+    raw_t m_begin[count];
+};
+
+// Counts the hardware events from its construction, which is right before the benchmark loop, to
+// its destruction, and reports them per operation, that is the items processed, or per iteration if
+// the benchmark doesn't set them. Use pause_timing() and resume_timing() rather than the ones of
+// the state, so the setup in the loop isn't counted. The threads started by the benchmark aren't
+// counted.
+class perf_scope {
+   public:
+    explicit perf_scope(benchmark::State &state) noexcept
+        : m_state{state} {
+        perf_counters::instance().reset();
+        perf_counters::instance().start();
+    }
+
+    ~perf_scope() {
+        auto &counters = perf_counters::instance();
+        counters.stop();
+        double ops = static_cast<double>(m_state.items_processed());
+        if (ops <= 0) {
+            ops = static_cast<double>(m_state.iterations());
+        }
+        if (ops > 0) {
+            counters.report(m_state, ops);
+        }
+    }
+
+    void pause_timing() {
+        perf_counters::instance().stop();
+        m_state.PauseTiming();
+    }
+
+    void resume_timing() {
+        m_state.ResumeTiming();
+        perf_counters::instance().start();
+    }
+
+    perf_scope(const perf_scope &) = delete;
+    perf_scope &operator=(const perf_scope &) = delete;
+   private:
+    benchmark::State &m_state;
+};
@@ -0,0 +1,232 @@
+// SPDX-FileCopyrightText: 2025 TypeCombinator <typecombinator@foxmail.com>
+//
+// SPDX-License-Identifier: BSD 3-Clause
+
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <vector>
+
+// The workloads shared by all benchmarks. The keys are generated by a distribution, and the nodes
+// (apples) are built from the keys, the i-th node has the sn i. All generators are deterministic
+// for the seed.
+enum class keys : int {
+    uniform,        // [0, 8 * size]
+    zipf,           // The keys of Zipf(0.99) over "size" items, the hot ones are scattered.
+    sorted,         // 8 * i
+    reverse_sorted, // 8 * (size - i)
+    nearly_sorted,  // sorted, but 5% of the keys go back a little.
+    sawtooth,       // Ascending runs of 1024 keys, each run restarts a little higher.
+    zigzag,         // 8 * (size / 2 -+ i / 2), alternates between the smallest and the largest keys.
+    clustered,      // 64 dense ranges scattered over 2^40, the nodes pick a range randomly.
+    duplicates,     // [0, size / 64), so each key has about 64 nodes.
+    permutation,    // A permutation of [0, size), so a trace of [0, size) always hits.
+};
+
+inline constexpr int keys_count = static_cast<int>(keys::permutation) + 1;
+
+inline const char *keys_name(keys kind) noexcept {
+    switch (kind) {
+    case keys::uniform:
+        return "uniform";
+    case keys::zipf:
+        return "zipf";
+    case keys::sorted:
+        return "sorted";
+    case keys::reverse_sorted:
+        return "reverse_sorted";
+    case keys::nearly_sorted:
+        return "nearly_sorted";
+    case keys::sawtooth:
+        return "sawtooth";
+    case keys::zigzag:
+        return "zigzag";
+    case keys::clustered:
+        return "clustered";
+    case keys::duplicates:
+        return "duplicates";
+    default:
+        return "permutation";
+    }
+}
+
+// Returns "count" indices in [0, n), the index of the k-th hottest item is drawn with a
+// probability proportional to 1 / k^theta, and theta 0 is uniform. The hot items are scattered
+// over [0, n) by a random permutation.
+inline std::vector<uint32_t>
+    generate_zipf_trace(uint32_t seed, uint32_t n, uint32_t count, double theta) {
+    std::mt19937 gen(seed);
+    std::vector<double> cdf(n);
+    double sum = 0;
+    for (uint32_t k = 0; k < n; k++) {
+        sum += 1.0 / std::pow(k + 1.0, theta);
+        cdf[k] = sum;
+    }
+    std::vector<uint32_t> permutation(n);
+    std::iota(permutation.begin(), permutation.end(), 0);
+    std::shuffle(permutation.begin(), permutation.end(), gen);
+
+    std::uniform_real_distribution<double> dis(0, sum);
+    std::vector<uint32_t> trace;
+    trace.reserve(count);
+    for (uint32_t i = 0; i < count; i++) {
+        auto k = std::lower_bound(cdf.begin(), cdf.end(), dis(gen)) - cdf.begin();
+        trace.push_back(permutation[k < n ? k : n - 1]);
+    }
+    return trace;
+}
+
+inline std::vector<uint64_t> generate_keys(uint32_t seed, uint32_t size, keys kind) {
+    std::vector<uint64_t> v;
+    std::mt19937 gen(seed);
+    v.reserve(size);
+    switch (kind) {
+    case keys::uniform: {
+        std::uniform_int_distribution<uint64_t> dis(0, uint64_t{size} * 8);
+        for (uint32_t i = 0; i < size; i++) {
+            v.push_back(dis(gen));
+        }
+        break;
+    }
+    case keys::zipf:
+        for (auto k: generate_zipf_trace(seed, size, size, 0.99)) {
+            v.push_back(uint64_t{k} * 8);
+        }
+        break;
+    case keys::sorted:
+        for (uint32_t i = 0; i < size; i++) {
+            v.push_back(uint64_t{i} * 8);
+        }
+        break;
+    case keys::reverse_sorted:
+        for (uint32_t i = 0; i < size; i++) {
+            v.push_back(uint64_t{size - i} * 8);
+        }
+        break;
+    case keys::nearly_sorted: {
+        std::uniform_int_distribution<uint32_t> dis(0, 99);
+        for (uint32_t i = 0; i < size; i++) {
+            uint64_t key = uint64_t{i} * 8;
+            if (dis(gen) < 5) {
+                key -= (key < 64 ? key : 64);
+            }
+            v.push_back(key);
+        }
+        break;
+    }
+    case keys::sawtooth: {
+        const uint32_t run = 1024;
+        for (uint32_t i = 0; i < size; i++) {
+            v.push_back((uint64_t{i % run} * (size / run + 1) + i / run) * 8);
+        }
+        break;
+    }
+    case keys::zigzag:
+        for (uint32_t i = 0; i < size; i++) {
+            uint64_t key = (i % 2 == 0) ? (size / 2 - i / 2) : (size / 2 + 1 + i / 2);
+            v.push_back(key * 8);
+        }
+        break;
+    case keys::clustered: {
+        const uint32_t clusters = 64;
+        std::uniform_int_distribution<uint64_t> base_dis(0, uint64_t{1} << 40);
+        std::uniform_int_distribution<uint32_t> dis(0, clusters - 1);
+        std::vector<uint64_t> next(clusters);
+        for (auto &n: next) {
+            n = base_dis(gen);
+        }
+        for (uint32_t i = 0; i < size; i++) {
+            v.push_back(next[dis(gen)]++);
+        }
+        break;
+    }
+    case keys::duplicates: {
+        std::uniform_int_distribution<uint64_t> dis(0, std::max(size / 64, 1u) - 1);
+        for (uint32_t i = 0; i < size; i++) {
+            v.push_back(dis(gen));
+        }
+        break;
+    }
+    default:
+        for (uint32_t i = 0; i < size; i++) {
+            v.push_back(i);
+        }
+        std::shuffle(v.begin(), v.end(), gen);
+        break;
+    }
+    return v;
+}
+
+template <typename Apple>
+inline std::vector<Apple> generate_apples(uint32_t seed, uint32_t size, keys kind = keys::uniform) {
+    std::vector<Apple> v;
+    v.reserve(size);
+    int sn = 0;
+    for (auto k: generate_keys(seed, size, kind)) {
+        v.emplace_back(k, sn++);
+    }
+    return v;
+}
+
+enum class op : uint8_t {
+    insert,
+    erase,
+    find,
+};
+
+// The operation on the node of the index in the pool.
+struct operation {
+    op kind;
+    uint32_t index;
+};
+
+// Returns a trace of "count" operations over a pool of "size" nodes, the nodes [0, live) are in the
+// container before the trace. An insertion picks a node that isn't in the container, and an erasure
+// or a lookup picks one that is, so the trace can be replayed without checks. The rest of the
+// percentages are lookups. An empty pool has no operations.
+inline std::vector<operation> generate_trace(
+    uint32_t seed,
+    uint32_t size,
+    uint32_t live,
+    uint32_t count,
+    uint32_t insert_percent,
+    uint32_t erase_percent) {
+    std::vector<operation> trace;
+    if (size == 0) {
+        return trace;
+    }
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<uint32_t> percent(0, 99);
+    // The nodes in the container are [0, live) of the pool, the others are [live, size).
+    std::vector<uint32_t> pool(size);
+    std::iota(pool.begin(), pool.end(), 0);
+    trace.reserve(count);
+
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t p = percent(gen);
+        op kind = p < insert_percent                   ? op::insert
+                : p < (insert_percent + erase_percent) ? op::erase
+                                                       : op::find;
+        if ((kind == op::insert) && (live == size)) {
+            kind = op::find;
+        }
+        if ((kind != op::insert) && (live == 0)) {
+            kind = op::insert;
+        }
+        if (kind == op::insert) {
+            uint32_t j = std::uniform_int_distribution<uint32_t>(live, size - 1)(gen);
+            std::swap(pool[j], pool[live]);
+            trace.push_back({kind, pool[live++]});
+        } else {
+            uint32_t j = std::uniform_int_distribution<uint32_t>(0, live - 1)(gen);
+            trace.push_back({kind, pool[j]});
+            if (kind == op::erase) {
+                std::swap(pool[j], pool[--live]);
+            }
+        }
+    }
+    return trace;
+}
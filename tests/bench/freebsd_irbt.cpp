@@ -6,6 +6,8 @@
 #include <vector>
 #include <random>
 #include "common/freebsd_irbt.h"
+#include <common/workload.hpp>
+#include <common/perf_counters.hpp>
 
 #define FREEBSD_RBT_APPLE_BITS(_ptr_) (_RB_BITSUP(_ptr_, node) & _RB_LR)
 
@@ -57,24 +59,29 @@ static void freebsd_rbt_erase(struct freebsd_rbt *root, struct freebsd_rbt_apple
     }
 }
 
-// TODO: need a generic generator.
-static std::vector<freebsd_rbt_apple>
-    generate_random_vector(uint32_t seed, uint32_t size, uint32_t dis_a, uint32_t dis_b) {
-    std::vector<freebsd_rbt_apple> v;
-    std::mt19937 gen(seed);
-    std::uniform_int_distribution<uint32_t> dis(dis_a, dis_b);
-    v.reserve(size);
-    for (size_t i = 0; i < size; ++i) {
-        v.emplace_back(dis(gen), i);
+static struct freebsd_rbt_apple *
+    freebsd_rbt_find(struct freebsd_rbt *root, const struct freebsd_rbt_apple *node) {
+    freebsd_rbt_apple *cur = root->rbh_root;
+
+    while (cur != NULL) {
+        int cmp_ret = freebsd_rbt_apple_cmp(node, cur);
+        if (cmp_ret < 0) {
+            cur = RB_LEFT(cur, node);
+        } else if (cmp_ret > 0) {
+            cur = RB_RIGHT(cur, node);
+        } else {
+            return cur;
+        }
     }
-    return v;
+    return NULL;
 }
 
 static void freebsd_irbt_insert_multi_random(benchmark::State &state) {
     std::size_t size = state.range(0);
-    auto &&data = generate_random_vector(23, size, 0, size * 8);
+    auto &&data = generate_apples<freebsd_rbt_apple>(23, size);
     struct freebsd_rbt tree = {NULL};
 
+    perf_scope perf(state);
     for (auto _: state) {
         for (auto &i: data) {
             freebsd_rbt_insert_multi(&tree, &i);
@@ -92,15 +99,16 @@ BENCHMARK(freebsd_irbt_insert_multi_random)
 
 static void freebsd_irbt_erase_random(benchmark::State &state) {
     std::size_t size = state.range(0);
-    auto &&data = generate_random_vector(23, size, 0, size * 8);
+    auto &&data = generate_apples<freebsd_rbt_apple>(23, size);
     struct freebsd_rbt tree = {NULL};
 
+    perf_scope perf(state);
     for (auto _: state) {
-        state.PauseTiming();
+        perf.pause_timing();
         for (auto &e: data) {
             freebsd_rbt_insert_multi(&tree, &e);
         }
-        state.ResumeTiming();
+        perf.resume_timing();
 
         for (auto &e: data) {
             freebsd_rbt_erase(&tree, &e);
@@ -113,4 +121,44 @@ static void freebsd_irbt_erase_random(benchmark::State &state) {
     state.SetComplexityN(state.range(0));
 }
 
-BENCHMARK(freebsd_irbt_erase_random)->RangeMultiplier(2)->Range(1 << 10, 1 << 18)->Complexity();
\ No newline at end of file
+BENCHMARK(freebsd_irbt_erase_random)->RangeMultiplier(2)->Range(1 << 10, 1 << 18)->Complexity();
+
+static void freebsd_irbt_find_random(benchmark::State &state) {
+    std::size_t size = state.range(0);
+    auto &&data = generate_apples<freebsd_rbt_apple>(23, size);
+    struct freebsd_rbt tree = {NULL};
+
+    for (auto &e: data) {
+        freebsd_rbt_insert_multi(&tree, &e);
+    }
+    perf_scope perf(state);
+    for (auto _: state) {
+        for (const auto &e: data) {
+            benchmark::DoNotOptimize(freebsd_rbt_find(&tree, &e));
+        }
+    }
+    state.SetComplexityN(state.range(0));
+}
+
+BENCHMARK(freebsd_irbt_find_random)->RangeMultiplier(2)->Range(1 << 10, 1 << 18)->Complexity();
+// The second argument is theta * 100 of the Zipf trace.
+static void freebsd_irbt_find_zipf(benchmark::State &state) {
+    const uint32_t trace_size = 1 << 16;
+    std::size_t size = state.range(0);
+    auto &&data = generate_apples<freebsd_rbt_apple>(23, size);
+    auto &&trace = generate_zipf_trace(29, size, trace_size, state.range(1) / 100.0);
+    struct freebsd_rbt tree = {NULL};
+
+    for (auto &e: data) {
+        freebsd_rbt_insert_multi(&tree, &e);
+    }
+    perf_scope perf(state);
+    for (auto _: state) {
+        for (auto k: trace) {
+            benchmark::DoNotOptimize(freebsd_rbt_find(&tree, &data[k]));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * trace_size);
+}
+
+BENCHMARK(freebsd_irbt_find_zipf)->ArgsProduct({{1 << 14, 1 << 20}, {0, 99, 120}});
@@ -0,0 +1,545 @@
+// SPDX-FileCopyrightText: 2025 TypeCombinator <typecombinator@foxmail.com>
+//
+// SPDX-License-Identifier: BSD 3-Clause
+
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <random>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+#include <common/apple.hpp>
+#include <common/workload.hpp>
+#include <common/perf_counters.hpp>
+#include <uit/idheap.hpp>
+#include <uit/iiqheap.hpp>
+#include <uit/irheap.hpp>
+
+// The heaps are compared in the hold model and in a timer trace, see Jones, An empirical comparison
+// of priority-queue and event-set implementations, 1986. The baselines are std::priority_queue, a
+// binary heap that stores the index in the node and a pairing heap. The arities of idheap are also
+// compared in a push-heavy and a pop-heavy workload. Each benchmark reports the time per operation
+// in "op".
+
+using irheap_t = uit::irheap<&heap_apple::right, &heap_apple::left>;
+using iiqheap_t = uit::iiqheap<&heap_apple::index>;
+using iiqheap_segmented_t =
+    uit::iiqheap<&heap_apple::index, std::less<>, uit::segmented<std::allocator<heap_apple *>>>;
+// The weight is kept in the slot with the pointer, so the sifts don't load the nodes.
+using iiqheap_key_t = uit::iiqheap<
+    &heap_apple::index,
+    std::less<>,
+    uit::key_inline<std::allocator<heap_apple *>, &heap_apple::weight>>;
+
+// The arities of idheap with the pointer-only and the key-inline layouts.
+template <unsigned Arity>
+using idheap_t = uit::idheap<&heap_apple::index, Arity>;
+template <unsigned Arity>
+using idheap_key_t = uit::idheap<
+    &heap_apple::index,
+    Arity,
+    std::less<>,
+    uit::key_inline<std::allocator<heap_apple *>, &heap_apple::weight>>;
+
+// The binary counterpart of iiqheap, so the arity is the only difference.
+struct binary_iheap {
+    explicit binary_iheap(uint32_t reserve) {
+        nodes.reserve(reserve);
+    }
+
+    heap_apple &top() const noexcept {
+        return *nodes[0];
+    }
+
+    void push(heap_apple *node) {
+        nodes.push_back(node);
+        sift_up(node, nodes.size() - 1);
+    }
+
+    void pop() noexcept {
+        heap_apple *last = nodes.back();
+        nodes.pop_back();
+        if (!nodes.empty()) {
+            sift_down(last, 0);
+        }
+    }
+
+    void remove(heap_apple *node) noexcept {
+        uint32_t i = node->index;
+        heap_apple *last = nodes.back();
+        nodes.pop_back();
+        if (i < nodes.size()) {
+            if ((i > 0) && (*last < *nodes[(i - 1) / 2])) {
+                sift_up(last, i);
+            } else {
+                sift_down(last, i);
+            }
+        }
+    }
+
+    void sift_up(heap_apple *node, uint32_t i) noexcept {
+        while (i > 0) {
+            uint32_t parent = (i - 1) / 2;
+            if (!(*node < *nodes[parent])) {
+                break;
+            }
+            nodes[i] = nodes[parent];
+            nodes[i]->index = i;
+            i = parent;
+        }
+        nodes[i] = node;
+        node->index = i;
+    }
+
+    void sift_down(heap_apple *node, uint32_t i) noexcept {
+        uint32_t size = nodes.size();
+        for (uint32_t child = 2 * i + 1; child < size; child = 2 * i + 1) {
+            if ((child + 1 < size) && (*nodes[child + 1] < *nodes[child])) {
+                child++;
+            }
+            if (!(*nodes[child] < *node)) {
+                break;
+            }
+            nodes[i] = nodes[child];
+            nodes[i]->index = i;
+            i = child;
+        }
+        nodes[i] = node;
+        node->index = i;
+    }
+
+    std::vector<heap_apple *> nodes;
+};
+
+// A pairing heap with the two-pass merge, see Fredman et al., The pairing heap: a new form of
+// self-adjusting heap, 1986.
+struct pairing_heap {
+    heap_apple &top() const noexcept {
+        return *root;
+    }
+
+    void push(heap_apple *node) noexcept {
+        node->left = nullptr;
+        node->right = nullptr;
+        node->prev = nullptr;
+        root = (root == nullptr) ? node : meld(root, node);
+    }
+
+    void pop() noexcept {
+        root = merge_pairs(root->left);
+    }
+
+    void remove(heap_apple *node) noexcept {
+        if (node == root) {
+            pop();
+            return;
+        }
+        if (node->prev->left == node) {
+            node->prev->left = node->right;
+        } else {
+            node->prev->right = node->right;
+        }
+        if (node->right != nullptr) {
+            node->right->prev = node->prev;
+        }
+        heap_apple *sub = merge_pairs(node->left);
+        if (sub != nullptr) {
+            root = meld(root, sub);
+        }
+    }
+
+    // Both are roots, the loser becomes the first child of the winner.
+    static heap_apple *meld(heap_apple *a, heap_apple *b) noexcept {
+        if (*b < *a) {
+            std::swap(a, b);
+        }
+        b->prev = a;
+        b->right = a->left;
+        if (a->left != nullptr) {
+            a->left->prev = b;
+        }
+        a->left = b;
+        return a;
+    }
+
+    static heap_apple *merge_pairs(heap_apple *first) noexcept {
+        if (first == nullptr) {
+            return nullptr;
+        }
+        // The first pass melds the pairs from left to right, and stacks them by right.
+        heap_apple *pairs = nullptr;
+        while (first != nullptr) {
+            heap_apple *a = first;
+            heap_apple *b = a->right;
+            if (b == nullptr) {
+                a->right = pairs;
+                pairs = a;
+                break;
+            }
+            first = b->right;
+            a = meld(a, b);
+            a->right = pairs;
+            pairs = a;
+        }
+        // The second pass melds them from right to left.
+        heap_apple *result = pairs;
+        pairs = pairs->right;
+        while (pairs != nullptr) {
+            heap_apple *next = pairs->right;
+            result = meld(result, pairs);
+            pairs = next;
+        }
+        result->right = nullptr;
+        result->prev = nullptr;
+        return result;
+    }
+
+    heap_apple *root = nullptr;
+};
+
+struct apple_greater {
+    bool operator()(const heap_apple *a, const heap_apple *b) const noexcept {
+        return b->weight < a->weight;
+    }
+};
+
+struct std_heap {
+    heap_apple &top() const noexcept {
+        return *q.top();
+    }
+
+    void push(heap_apple *node) {
+        q.push(node);
+    }
+
+    void pop() {
+        q.pop();
+    }
+
+    std::priority_queue<heap_apple *, std::vector<heap_apple *>, apple_greater> q;
+};
+
+template <typename Heap>
+static Heap make_heap(uint32_t reserve) {
+    if constexpr (std::is_constructible_v<Heap, uint32_t>) {
+        return Heap(reserve);
+    } else {
+        return Heap{};
+    }
+}
+
+static void set_per_op(benchmark::State &state, double ops = 1) {
+    state.counters["op"] = benchmark::Counter(
+        ops, benchmark::Counter::kIsIterationInvariantRate | benchmark::Counter::kInvert);
+}
+
+// The increments of the hold model, they're exponential with the mean of "8 * size", the spread of
+// the initial keys.
+static std::vector<uint64_t> generate_increments(uint32_t seed, uint32_t size) {
+    std::mt19937 gen(seed);
+    std::exponential_distribution<double> dis(1.0 / (8.0 * size));
+    std::vector<uint64_t> v(1 << 16);
+    for (auto &e: v) {
+        e = static_cast<uint64_t>(dis(gen)) + 1;
+    }
+    return v;
+}
+
+// The hold model: pop the min and push it back with a random increment, the size stays the same.
+// The fused one replaces the top by itself, that's one sift down.
+template <typename Heap, bool Fused = false>
+static void hold(benchmark::State &state) {
+    uint32_t size = state.range(0);
+    auto &&data = generate_apples<heap_apple>(23, size);
+    auto &&increments = generate_increments(29, size);
+    auto q = make_heap<Heap>(size);
+    for (auto &e: data) {
+        q.push(&e);
+    }
+
+    std::size_t i = 0;
+    perf_scope perf(state);
+    for (auto _: state) {
+        heap_apple *node = &q.top();
+        node->weight += increments[i++ & 0xffff];
+        if constexpr (Fused) {
+            q.replace_top(node);
+        } else {
+            q.pop();
+            q.push(node);
+        }
+    }
+    benchmark::DoNotOptimize(&q.top());
+    set_per_op(state);
+}
+
+// A trace of the timers over a pool of "2 * size" nodes, "size" of them are pending before the
+// trace. The insertions of generate_trace schedule a timer, the erasures cancel one, and the
+// lookups expire the earliest timer and schedule it again, so it's periodic. The trace is followed
+// by its inverse, the pending timers are the same at both ends, so it can be replayed in a loop.
+static std::vector<operation> generate_timer_trace(uint32_t seed, uint32_t size) {
+    auto &&trace = generate_trace(seed, size * 2, size, 1 << 15, 40, 40);
+    trace.reserve(trace.size() * 2);
+    for (std::size_t i = trace.size(); i-- > 0;) {
+        operation o = trace[i];
+        o.kind = o.kind == op::insert ? op::erase : o.kind == op::erase ? op::insert : op::find;
+        trace.push_back(o);
+    }
+    return trace;
+}
+
+// The cancellation requires the removal of any node, so irheap isn't in this benchmark. The fused
+// one reschedules the expired timer by replace_top.
+template <typename Heap, bool Fused = false>
+static void timer(benchmark::State &state) {
+    uint32_t size = state.range(0);
+    auto &&data = generate_apples<heap_apple>(23, size * 2);
+    auto &&delays = generate_increments(29, size);
+    auto &&trace = generate_timer_trace(31, size);
+    auto q = make_heap<Heap>(size * 2);
+    for (uint32_t i = 0; i < size; i++) {
+        q.push(&data[i]);
+    }
+
+    uint64_t now = 0;
+    std::size_t i = 0;
+    perf_scope perf(state);
+    for (auto _: state) {
+        operation o = trace[i % trace.size()];
+        heap_apple *node = &data[o.index];
+        if (o.kind == op::insert) {
+            node->weight = now + delays[i & 0xffff];
+            q.push(node);
+        } else if (o.kind == op::erase) {
+            q.remove(node);
+        } else {
+            node = &q.top();
+            now = node->weight;
+            node->weight = now + delays[i & 0xffff];
+            if constexpr (Fused) {
+                q.replace_top(node);
+            } else {
+                q.pop();
+                q.push(node);
+            }
+        }
+        i++;
+    }
+    benchmark::DoNotOptimize(&q.top());
+    set_per_op(state);
+}
+
+// A node out of the heap is pushed and the min is popped, the popped node is the next one, so the
+// size stays the same. The new key is the current time plus a short delay, so some of the nodes
+// would be the top at once, then the fused push_pop returns them without a sift.
+template <typename Heap, bool Fused = false>
+static void push_pop(benchmark::State &state) {
+    uint32_t size = state.range(0);
+    auto &&data = generate_apples<heap_apple>(23, size + 1);
+    auto &&delays = generate_increments(29, size);
+    auto q = make_heap<Heap>(size);
+    for (uint32_t i = 0; i < size; i++) {
+        q.push(&data[i]);
+    }
+
+    heap_apple *out = &data[size];
+    uint64_t now = q.top().weight;
+    std::size_t i = 0;
+    perf_scope perf(state);
+    for (auto _: state) {
+        out->weight = now + delays[i++ & 0xffff] / 8;
+        if constexpr (Fused) {
+            out = q.push_pop(out);
+        } else {
+            q.push(out);
+            out = &q.top();
+            q.pop();
+        }
+        now = out->weight;
+    }
+    benchmark::DoNotOptimize(out);
+    set_per_op(state);
+}
+
+// The push-heavy workload: "size" nodes are pushed into an empty heap, the storage is reserved.
+// The keys are uniform, or reversed, so each push sifts up to the root.
+template <typename Heap, keys Kind = keys::uniform>
+static void grow(benchmark::State &state) {
+    uint32_t size = state.range(0);
+    auto &&data = generate_apples<heap_apple>(23, size, Kind);
+    auto q = make_heap<Heap>(size);
+
+    perf_scope perf(state);
+    for (auto _: state) {
+        for (auto &e: data) {
+            q.push(&e);
+        }
+        perf.pause_timing();
+        q.clear();
+        perf.resume_timing();
+    }
+    set_per_op(state, size);
+}
+
+// The same nodes as grow are built into a heap by Floyd's heapify.
+template <typename Heap, keys Kind = keys::uniform>
+static void heapify(benchmark::State &state) {
+    uint32_t size = state.range(0);
+    auto &&data = generate_apples<heap_apple>(23, size, Kind);
+    std::vector<heap_apple *> batch;
+    for (auto &e: data) {
+        batch.push_back(&e);
+    }
+    auto q = make_heap<Heap>(size);
+
+    perf_scope perf(state);
+    for (auto _: state) {
+        q.assign(batch);
+        benchmark::DoNotOptimize(&q.top());
+    }
+    set_per_op(state, size);
+}
+
+// The pop-heavy workload: a heap of "size" nodes is drained.
+template <typename Heap>
+static void drain(benchmark::State &state) {
+    uint32_t size = state.range(0);
+    auto &&data = generate_apples<heap_apple>(23, size);
+    auto q = make_heap<Heap>(size);
+
+    perf_scope perf(state);
+    for (auto _: state) {
+        perf.pause_timing();
+        for (auto &e: data) {
+            q.push(&e);
+        }
+        perf.resume_timing();
+        while (!q.empty()) {
+            q.pop();
+        }
+    }
+    set_per_op(state, size);
+}
+
+// std::priority_queue can't remove a node, so the cancellation is lazy: it bumps the generation of
+// the timer, the stale entries are dropped when they reach the top.
+static void std_heap_timer(benchmark::State &state) {
+    using entry_t = std::tuple<uint64_t, uint32_t, heap_apple *>;
+    uint32_t size = state.range(0);
+    auto &&data = generate_apples<heap_apple>(23, size * 2);
+    auto &&delays = generate_increments(29, size);
+    auto &&trace = generate_timer_trace(31, size);
+    std::priority_queue<entry_t, std::vector<entry_t>, std::greater<>> q;
+    for (uint32_t i = 0; i < size * 2; i++) {
+        data[i].index = 0;
+        if (i < size) {
+            q.emplace(data[i].weight, 0, &data[i]);
+        }
+    }
+
+    uint64_t now = 0;
+    std::size_t i = 0;
+    perf_scope perf(state);
+    for (auto _: state) {
+        operation o = trace[i % trace.size()];
+        heap_apple *node = &data[o.index];
+        if (o.kind == op::insert) {
+            node->weight = now + delays[i & 0xffff];
+            q.emplace(node->weight, node->index, node);
+        } else if (o.kind == op::erase) {
+            node->index++;
+        } else {
+            while (std::get<1>(q.top()) != std::get<2>(q.top())->index) {
+                q.pop();
+            }
+            node = std::get<2>(q.top());
+            now = node->weight;
+            q.pop();
+            node->weight = now + delays[i & 0xffff];
+            q.emplace(node->weight, node->index, node);
+        }
+        i++;
+    }
+    benchmark::DoNotOptimize(&q.top());
+    set_per_op(state);
+}
+
+#define HEAP_BENCHMARK(func, heap)                                                                 \
+    BENCHMARK(func<heap>)->Name(#heap "/" #func)->RangeMultiplier(10)->Range(100, 10000000)
+
+HEAP_BENCHMARK(hold, irheap_t);
+HEAP_BENCHMARK(hold, iiqheap_t);
+HEAP_BENCHMARK(hold, iiqheap_segmented_t);
+HEAP_BENCHMARK(hold, iiqheap_key_t);
+HEAP_BENCHMARK(hold, binary_iheap);
+HEAP_BENCHMARK(hold, pairing_heap);
+HEAP_BENCHMARK(hold, std_heap);
+
+HEAP_BENCHMARK(timer, iiqheap_t);
+HEAP_BENCHMARK(timer, iiqheap_segmented_t);
+HEAP_BENCHMARK(timer, iiqheap_key_t);
+HEAP_BENCHMARK(timer, binary_iheap);
+HEAP_BENCHMARK(timer, pairing_heap);
+BENCHMARK(std_heap_timer)->Name("std_heap/timer")->RangeMultiplier(10)->Range(100, 10000000);
+
+// The pop and push of the rescheduling against the fused operations.
+#define FUSED_BENCHMARK(func, heap)                                                                \
+    BENCHMARK(func<heap, true>)                                                                    \
+        ->Name(#heap "/" #func "_fused")                                                           \
+        ->RangeMultiplier(10)                                                                      \
+        ->Range(100, 10000000)
+
+FUSED_BENCHMARK(hold, irheap_t);
+FUSED_BENCHMARK(hold, iiqheap_t);
+FUSED_BENCHMARK(hold, iiqheap_segmented_t);
+FUSED_BENCHMARK(hold, iiqheap_key_t);
+
+FUSED_BENCHMARK(timer, iiqheap_t);
+FUSED_BENCHMARK(timer, iiqheap_segmented_t);
+FUSED_BENCHMARK(timer, iiqheap_key_t);
+
+HEAP_BENCHMARK(push_pop, irheap_t);
+HEAP_BENCHMARK(push_pop, iiqheap_t);
+HEAP_BENCHMARK(push_pop, iiqheap_key_t);
+FUSED_BENCHMARK(push_pop, irheap_t);
+FUSED_BENCHMARK(push_pop, iiqheap_t);
+FUSED_BENCHMARK(push_pop, iiqheap_key_t);
+
+// The restoration of the timers, the push one by one against the heapify.
+HEAP_BENCHMARK(grow, irheap_t);
+HEAP_BENCHMARK(heapify, irheap_t);
+HEAP_BENCHMARK(heapify, iiqheap_t);
+HEAP_BENCHMARK(heapify, iiqheap_segmented_t);
+HEAP_BENCHMARK(heapify, iiqheap_key_t);
+
+#define REVERSED_BENCHMARK(func, heap)                                                             \
+    BENCHMARK(func<heap, keys::reverse_sorted>)                                                    \
+        ->Name(#heap "/" #func "_reversed")                                                        \
+        ->RangeMultiplier(10)                                                                      \
+        ->Range(100, 10000000)
+
+REVERSED_BENCHMARK(grow, irheap_t);
+REVERSED_BENCHMARK(heapify, irheap_t);
+REVERSED_BENCHMARK(grow, iiqheap_t);
+REVERSED_BENCHMARK(heapify, iiqheap_t);
+REVERSED_BENCHMARK(grow, iiqheap_key_t);
+REVERSED_BENCHMARK(heapify, iiqheap_key_t);
+
+// The sweep of the arity per workload and size, the 4-ary heap is iiqheap.
+#define ARITY_BENCHMARK(func)                                                                      \
+    HEAP_BENCHMARK(func, idheap_t<2>);                                                             \
+    HEAP_BENCHMARK(func, idheap_t<4>);                                                             \
+    HEAP_BENCHMARK(func, idheap_t<8>);                                                             \
+    HEAP_BENCHMARK(func, idheap_t<16>);                                                            \
+    HEAP_BENCHMARK(func, idheap_key_t<2>);                                                         \
+    HEAP_BENCHMARK(func, idheap_key_t<4>);                                                         \
+    HEAP_BENCHMARK(func, idheap_key_t<8>);                                                         \
+    HEAP_BENCHMARK(func, idheap_key_t<16>)
+
+ARITY_BENCHMARK(hold);
+ARITY_BENCHMARK(timer);
+ARITY_BENCHMARK(grow);
+ARITY_BENCHMARK(heapify);
+ARITY_BENCHMARK(drain);
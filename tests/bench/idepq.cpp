@@ -0,0 +1,82 @@
+// SPDX-FileCopyrightText: 2025 TypeCombinator <typecombinator@foxmail.com>
+//
+// SPDX-License-Identifier: BSD 3-Clause
+
+#include <benchmark/benchmark.h>
+#include <vector>
+#include <random>
+#include <queue>
+#include <common/apple.hpp>
+#include <common/workload.hpp>
+#include <common/perf_counters.hpp>
+#include <uit/idepq.hpp>
+
+using idepq_apple_t = uit::idepq<&rsbt_apple::right, &rsbt_apple::left, &rsbt_apple::size>;
+
+struct apple_less {
+    bool operator()(const rsbt_apple* a, const rsbt_apple* b) const noexcept {
+        return a->weight < b->weight;
+    }
+};
+
+static void idepq_top_k(benchmark::State& state) {
+    std::size_t capacity = state.range(0);
+    auto&& data = generate_apples<rsbt_apple>(23, capacity * 64);
+
+    perf_scope perf(state);
+    for (auto _: state) {
+        auto q = idepq_apple_t::bounded(capacity);
+        for (auto& e: data) {
+            benchmark::DoNotOptimize(q.push(&e));
+        }
+        benchmark::DoNotOptimize(q.top_min());
+    }
+    state.SetItemsProcessed(state.iterations() * data.size());
+}
+
+BENCHMARK(idepq_top_k)->Arg(1 << 10)->Arg(10000)->Arg(1 << 16);
+
+// The usual top-k with a max-heap, the min isn't available without a second heap.
+static void priority_queue_top_k(benchmark::State& state) {
+    std::size_t capacity = state.range(0);
+    auto&& data = generate_apples<rsbt_apple>(23, capacity * 64);
+
+    perf_scope perf(state);
+    for (auto _: state) {
+        std::priority_queue<rsbt_apple*, std::vector<rsbt_apple*>, apple_less> q;
+        for (auto& e: data) {
+            if (q.size() < capacity) {
+                q.push(&e);
+            } else if (e.weight < q.top()->weight) {
+                q.pop();
+                q.push(&e);
+            }
+        }
+        benchmark::DoNotOptimize(q.top());
+    }
+    state.SetItemsProcessed(state.iterations() * data.size());
+}
+
+BENCHMARK(priority_queue_top_k)->Arg(1 << 10)->Arg(10000)->Arg(1 << 16);
+
+// Pop from either end and push the node back with a new weight, the size stays the same.
+static void idepq_both_ends(benchmark::State& state) {
+    std::size_t size = state.range(0);
+    auto&& data = generate_apples<rsbt_apple>(23, size);
+    std::mt19937 gen(29);
+    std::uniform_int_distribution<uint64_t> dis(0, UINT32_MAX);
+    idepq_apple_t q{};
+
+    for (auto& e: data) {
+        q.push(&e);
+    }
+    perf_scope perf(state);
+    for (auto _: state) {
+        rsbt_apple* node = (gen() & 1) ? q.pop_min() : q.pop_max();
+        node->weight = dis(gen);
+        q.push(node);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(idepq_both_ends)->Range(1 << 10, 1 << 18);
@@ -0,0 +1,103 @@
+// SPDX-FileCopyrightText: 2025 TypeCombinator <typecombinator@foxmail.com>
+//
+// SPDX-License-Identifier: BSD 3-Clause
+
+#include <benchmark/benchmark.h>
+#include <vector>
+#include <random>
+#include <common/apple.hpp>
+#include <common/workload.hpp>
+#include <common/perf_counters.hpp>
+#include <uit/irbt.hpp>
+
+using irbt_apple_t =
+    uit::irbt<&rbt_apple::right, &rbt_apple::left, &rbt_apple::parent, &rbt_apple::color>;
+
+static void irbt_insert_multi_random(benchmark::State& state) {
+    std::size_t size = state.range(0);
+    auto&& data = generate_apples<rbt_apple>(23, size);
+    irbt_apple_t tree{};
+
+    perf_scope perf(state);
+    for (auto _: state) {
+        for (auto& e: data) {
+            tree.insert_multi(&e);
+        }
+        tree.clear();
+    }
+    state.SetComplexityN(state.range(0));
+}
+
+BENCHMARK(irbt_insert_multi_random)->RangeMultiplier(2)->Range(1 << 10, 1 << 18)->Complexity();
+
+static void irbt_erase_random(benchmark::State& state) {
+    std::size_t size = state.range(0);
+    auto&& data = generate_apples<rbt_apple>(23, size);
+    irbt_apple_t tree{};
+
+    perf_scope perf(state);
+    for (auto _: state) {
+        perf.pause_timing();
+        for (auto& e: data) {
+            tree.insert_multi(&e);
+        }
+        perf.resume_timing();
+
+        for (const auto& e: data) {
+            tree.remove(e); // A lookup, then erase, like the Linux and FreeBSD benchmarks.
+        }
+        if (!tree.empty()) {
+            state.SkipWithError("The tree is not empty.");
+            break;
+        }
+    }
+    state.SetComplexityN(state.range(0));
+}
+
+BENCHMARK(irbt_erase_random)->RangeMultiplier(2)->Range(1 << 10, 1 << 18)->Complexity();
+
+// The nodes are erased directly by their parent pointers, there's no lookup.
+static void irbt_erase_node_random(benchmark::State& state) {
+    std::size_t size = state.range(0);
+    auto&& data = generate_apples<rbt_apple>(23, size);
+    irbt_apple_t tree{};
+
+    perf_scope perf(state);
+    for (auto _: state) {
+        perf.pause_timing();
+        for (auto& e: data) {
+            tree.insert_multi(&e);
+        }
+        perf.resume_timing();
+
+        for (auto& e: data) {
+            tree.erase(&e);
+        }
+        if (!tree.empty()) {
+            state.SkipWithError("The tree is not empty.");
+            break;
+        }
+    }
+    state.SetComplexityN(state.range(0));
+}
+
+BENCHMARK(irbt_erase_node_random)->RangeMultiplier(2)->Range(1 << 10, 1 << 18)->Complexity();
+
+static void irbt_find_random(benchmark::State& state) {
+    std::size_t size = state.range(0);
+    auto&& data = generate_apples<rbt_apple>(23, size);
+    irbt_apple_t tree{};
+
+    for (auto& e: data) {
+        tree.insert_multi(&e);
+    }
+    perf_scope perf(state);
+    for (auto _: state) {
+        for (const auto& e: data) {
+            benchmark::DoNotOptimize(tree.find(e));
+        }
+    }
+    state.SetComplexityN(state.range(0));
+}
+
+BENCHMARK(irbt_find_random)->RangeMultiplier(2)->Range(1 << 10, 1 << 18)->Complexity();
@@ -6,35 +6,88 @@
 #include <vector>
 #include <random>
 #include <common/apple.hpp>
+#include <common/workload.hpp>
+#include <common/perf_counters.hpp>
 #include <uit/irsbt.hpp>
 
 using irsbt_apple_t = uit::irsbt<&rsbt_apple::right, &rsbt_apple::left, &rsbt_apple::size>;
 
-// TODO: need a generic generator.
-static std::vector<rsbt_apple>
-    generate_random_vector(uint32_t seed, uint32_t size, uint32_t dis_a, uint32_t dis_b) {
-    std::vector<rsbt_apple> v;
-    std::mt19937 gen(seed);
-    std::uniform_int_distribution<uint32_t> dis(dis_a, dis_b);
-    v.reserve(size);
-    for (size_t i = 0; i < size; ++i) {
-        v.emplace_back(dis(gen), i);
+static void isbt_insert_multi_random(benchmark::State& state) {
+    std::size_t size = state.range(0);
+    auto&& data = generate_apples<rsbt_apple>(23, size);
+    irsbt_apple_t tree{};
+
+    perf_scope perf(state);
+    for (auto _: state) {
+        for (auto& e: data) {
+            tree.insert_multi(&e);
+        }
+        tree.clear();
     }
-    return v;
+    state.SetComplexityN(state.range(0));
 }
 
-static void isbt_insert_multi_random(benchmark::State& state) {
+BENCHMARK(isbt_insert_multi_random)->RangeMultiplier(2)->Range(1 << 10, 1 << 18)->Complexity();
+
+static void isbt_insert_multi_monotonic(benchmark::State& state) {
     std::size_t size = state.range(0);
-    auto&& data = generate_random_vector(23, size, 0, size * 8);
+    std::vector<rsbt_apple> data;
     irsbt_apple_t tree{};
 
+    data.reserve(size);
+    for (std::size_t i = 0; i < size; i++) {
+        data.emplace_back(i, i);
+    }
+    perf_scope perf(state);
     for (auto _: state) {
         for (auto& e: data) {
             tree.insert_multi(&e);
         }
         tree.clear();
     }
-    state.SetComplexityN(state.range(0));
+    state.SetItemsProcessed(state.iterations() * size);
+}
+
+BENCHMARK(isbt_insert_multi_monotonic)->RangeMultiplier(16)->Range(1 << 10, 1 << 18);
+
+static void isbt_push_back_max_monotonic(benchmark::State& state) {
+    std::size_t size = state.range(0);
+    std::vector<rsbt_apple> data;
+    irsbt_apple_t tree{};
+
+    data.reserve(size);
+    for (std::size_t i = 0; i < size; i++) {
+        data.emplace_back(i, i);
+    }
+    perf_scope perf(state);
+    for (auto _: state) {
+        for (auto& e: data) {
+            tree.push_back_max(&e);
+        }
+        tree.clear();
+    }
+    state.SetItemsProcessed(state.iterations() * size);
+}
+
+BENCHMARK(isbt_push_back_max_monotonic)->RangeMultiplier(16)->Range(1 << 10, 1 << 18);
+
+// The second argument is the distribution of the keys, see common/workload.hpp.
+static void isbt_insert_multi_keys(benchmark::State& state) {
+    std::size_t size = state.range(0);
+    auto kind = static_cast<keys>(state.range(1));
+    auto&& data = generate_apples<rsbt_apple>(23, size, kind);
+    irsbt_apple_t tree{};
+
+    perf_scope perf(state);
+    for (auto _: state) {
+        for (auto& e: data) {
+            tree.insert_multi(&e);
+        }
+        tree.clear();
+    }
+    state.SetItemsProcessed(state.iterations() * size);
+    state.SetLabel(keys_name(kind));
 }
 
-BENCHMARK(isbt_insert_multi_random)->RangeMultiplier(2)->Range(1 << 10, 1 << 18)->Complexity();
\ No newline at end of file
+BENCHMARK(isbt_insert_multi_keys)
+    ->ArgsProduct({{1 << 10, 1 << 18}, benchmark::CreateDenseRange(0, keys_count - 1, 1)});
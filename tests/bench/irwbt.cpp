@@ -0,0 +1,468 @@
+// SPDX-FileCopyrightText: 2025 TypeCombinator <typecombinator@foxmail.com>
+//
+// SPDX-License-Identifier: BSD 3-Clause
+
+#include <benchmark/benchmark.h>
+#include <vector>
+#include <random>
+#include <common/apple.hpp>
+#include <common/workload.hpp>
+#include <common/perf_counters.hpp>
+#include <uit/irwbt.hpp>
+
+using irwbt_apple_t = uit::irwbt<&rsbt_apple::right, &rsbt_apple::left, &rsbt_apple::size>;
+
+static void irwbt_insert_multi_monotonic(benchmark::State& state) {
+    std::size_t size = state.range(0);
+    auto&& data = generate_apples<rsbt_apple>(23, size, static_cast<keys>(state.range(1)));
+    irwbt_apple_t tree{};
+
+    perf_scope perf(state);
+    for (auto _: state) {
+        for (auto& e: data) {
+            tree.insert_multi(&e);
+        }
+        tree.clear();
+    }
+    state.SetItemsProcessed(state.iterations() * size);
+}
+
+BENCHMARK(irwbt_insert_multi_monotonic)->ArgsProduct(
+    {{1 << 10, 1 << 14, 1 << 18}, {int(keys::sorted), int(keys::nearly_sorted)}});
+
+static void irwbt_insert_hint_monotonic(benchmark::State& state) {
+    std::size_t size = state.range(0);
+    auto&& data = generate_apples<rsbt_apple>(23, size, static_cast<keys>(state.range(1)));
+    irwbt_apple_t tree{};
+
+    perf_scope perf(state);
+    for (auto _: state) {
+        rsbt_apple* hint = nullptr;
+        for (auto& e: data) {
+            tree.insert_hint(hint, &e);
+            if ((hint == nullptr) || !(e < *hint)) {
+                hint = &e;
+            }
+        }
+        tree.clear();
+    }
+    state.SetItemsProcessed(state.iterations() * size);
+}
+
+BENCHMARK(irwbt_insert_hint_monotonic)->ArgsProduct(
+    {{1 << 10, 1 << 14, 1 << 18}, {int(keys::sorted), int(keys::nearly_sorted)}});
+
+static void irwbt_push_back_max_monotonic(benchmark::State& state) {
+    std::size_t size = state.range(0);
+    auto&& data = generate_apples<rsbt_apple>(23, size, keys::sorted);
+    irwbt_apple_t tree{};
+
+    perf_scope perf(state);
+    for (auto _: state) {
+        for (auto& e: data) {
+            tree.push_back_max(&e);
+        }
+        tree.clear();
+    }
+    state.SetItemsProcessed(state.iterations() * size);
+}
+
+BENCHMARK(irwbt_push_back_max_monotonic)->ArgsProduct({{1 << 10, 1 << 14, 1 << 18}});
+
+// All nodes are inserted in the batches of the size "state.range(0)".
+static void irwbt_insert_multi_batched(benchmark::State& state) {
+    const std::size_t size = 1 << 16;
+    std::size_t batch_size = state.range(0);
+    auto&& data = generate_apples<rsbt_apple>(23, size);
+    irwbt_apple_t tree{};
+
+    perf_scope perf(state);
+    for (auto _: state) {
+        for (std::size_t i = 0; i < size; i += batch_size) {
+            for (std::size_t j = i; j < i + batch_size; j++) {
+                tree.insert_multi(&data[j]);
+            }
+        }
+        tree.clear();
+    }
+    state.SetItemsProcessed(state.iterations() * size);
+}
+
+BENCHMARK(irwbt_insert_multi_batched)->Arg(256)->Arg(1024)->Arg(4096);
+
+static void irwbt_insert_batch(benchmark::State& state) {
+    const std::size_t size = 1 << 16;
+    std::size_t batch_size = state.range(0);
+    auto&& data = generate_apples<rsbt_apple>(23, size);
+    std::vector<rsbt_apple*> batch(batch_size);
+    irwbt_apple_t tree{};
+
+    perf_scope perf(state);
+    for (auto _: state) {
+        for (std::size_t i = 0; i < size; i += batch_size) {
+            for (std::size_t j = 0; j < batch_size; j++) {
+                batch[j] = &data[i + j];
+            }
+            tree.insert_batch(batch);
+        }
+        tree.clear();
+    }
+    state.SetItemsProcessed(state.iterations() * size);
+}
+
+BENCHMARK(irwbt_insert_batch)->Arg(256)->Arg(1024)->Arg(4096);
+
+static void irwbt_insert_batch_radix(benchmark::State& state) {
+    const std::size_t size = 1 << 16;
+    std::size_t batch_size = state.range(0);
+    auto&& data = generate_apples<rsbt_apple>(23, size);
+    std::vector<rsbt_apple*> batch(batch_size);
+    irwbt_apple_t tree{};
+
+    perf_scope perf(state);
+    for (auto _: state) {
+        for (std::size_t i = 0; i < size; i += batch_size) {
+            for (std::size_t j = 0; j < batch_size; j++) {
+                batch[j] = &data[i + j];
+            }
+            tree.insert_batch<&rsbt_apple::weight>(batch);
+        }
+        tree.clear();
+    }
+    state.SetItemsProcessed(state.iterations() * size);
+}
+
+BENCHMARK(irwbt_insert_batch_radix)->Arg(256)->Arg(1024)->Arg(4096);
+
+using irwbt_cached_apple_t =
+    uit::irwbt_cached<&rsbt_apple::right, &rsbt_apple::left, &rsbt_apple::size>;
+
+// A deadline scheduler: peek at the earliest node, pop it, and push it back with a later deadline.
+template <typename Tree>
+static void scheduler_hold(benchmark::State& state) {
+    std::size_t size = state.range(0);
+    auto&& data = generate_apples<rsbt_apple>(23, size);
+    std::mt19937 gen(29);
+    std::uniform_int_distribution<uint64_t> dis(1, size);
+    Tree tree{};
+
+    for (auto& e: data) {
+        tree.insert_multi(&e);
+    }
+    perf_scope perf(state);
+    for (auto _: state) {
+        rsbt_apple* node = tree.front();
+        benchmark::DoNotOptimize(node);
+        tree.remove_leftmost();
+        node->weight += dis(gen);
+        tree.insert_multi(node);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(scheduler_hold<irwbt_apple_t>)->Name("irwbt_scheduler_hold")->Range(1 << 10, 1 << 18);
+BENCHMARK(scheduler_hold<irwbt_cached_apple_t>)
+    ->Name("irwbt_cached_scheduler_hold")
+    ->Range(1 << 10, 1 << 18);
+
+using irwbt_tiebreak_apple_t = uit::
+    irwbt<&rsbt_apple::right, &rsbt_apple::left, &rsbt_apple::size, uit::address_tiebreak<>>;
+
+// Cancel a random timer and arm it again, the second argument is the number of distinct deadlines,
+// so each deadline is shared by about (size / deadlines) timers.
+template <typename Tree>
+static void cancel(benchmark::State& state) {
+    std::size_t size = state.range(0);
+    std::vector<rsbt_apple> data;
+    std::mt19937 gen(23);
+    std::uniform_int_distribution<uint64_t> deadline_dis(0, state.range(1) - 1);
+    std::uniform_int_distribution<std::size_t> index_dis(0, size - 1);
+    Tree tree{};
+
+    data.reserve(size);
+    for (std::size_t i = 0; i < size; ++i) {
+        data.emplace_back(deadline_dis(gen), i);
+    }
+    for (auto& e: data) {
+        tree.insert_multi(&e);
+    }
+    perf_scope perf(state);
+    for (auto _: state) {
+        rsbt_apple* node = &data[index_dis(gen)];
+        benchmark::DoNotOptimize(tree.erase(node));
+        tree.insert_multi(node);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(cancel<irwbt_apple_t>)
+    ->Name("irwbt_cancel")
+    ->ArgsProduct({{1 << 10, 1 << 14, 1 << 18}, {16, 1 << 30}});
+BENCHMARK(cancel<irwbt_tiebreak_apple_t>)
+    ->Name("irwbt_tiebreak_cancel")
+    ->ArgsProduct({{1 << 10, 1 << 14, 1 << 18}, {16, 1 << 30}});
+
+// The sweep over the balance parameters, a smaller DELTA gives a lower tree but more rotations.
+// The height is reported as a counter.
+template <typename Delta, typename Gamma>
+using irwbt_balance_apple_t = uit::irwbt<
+    &rsbt_apple::right,
+    &rsbt_apple::left,
+    &rsbt_apple::size,
+    std::less<>,
+    uit::wbt_balance<Delta, Gamma>>;
+
+template <typename Tree>
+static void balance_insert(benchmark::State& state) {
+    std::size_t size = state.range(0);
+    auto&& data = generate_apples<rsbt_apple>(23, size);
+    Tree tree{};
+
+    perf_scope perf(state);
+    for (auto _: state) {
+        for (auto& e: data) {
+            tree.insert_multi(&e);
+        }
+        perf.pause_timing();
+        state.counters["height"] = tree.height();
+        tree.clear();
+        perf.resume_timing();
+    }
+    state.SetItemsProcessed(state.iterations() * size);
+}
+
+template <typename Tree>
+static void balance_find(benchmark::State& state) {
+    std::size_t size = state.range(0);
+    auto&& data = generate_apples<rsbt_apple>(23, size);
+    Tree tree{};
+
+    for (auto& e: data) {
+        tree.insert_multi(&e);
+    }
+    perf_scope perf(state);
+    for (auto _: state) {
+        for (auto& e: data) {
+            benchmark::DoNotOptimize(tree.find(e.weight));
+        }
+    }
+    state.counters["height"] = tree.height();
+    state.SetItemsProcessed(state.iterations() * size);
+}
+
+template <typename Tree>
+static void balance_remove(benchmark::State& state) {
+    std::size_t size = state.range(0);
+    auto&& data = generate_apples<rsbt_apple>(23, size);
+    Tree tree{};
+
+    perf_scope perf(state);
+    for (auto _: state) {
+        perf.pause_timing();
+        for (auto& e: data) {
+            tree.insert_multi(&e);
+        }
+        perf.resume_timing();
+        for (auto& e: data) {
+            benchmark::DoNotOptimize(tree.remove(e.weight));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * size);
+}
+
+#define BALANCE_BENCHMARK(func, dn, dd, gn, gd)                                                  \
+    BENCHMARK(func<irwbt_balance_apple_t<std::ratio<dn, dd>, std::ratio<gn, gd>>>)               \
+        ->Name("irwbt_" #func "<" #dn "/" #dd "," #gn "/" #gd ">")                               \
+        ->Arg(1 << 12)                                                                           \
+        ->Arg(1 << 18)
+
+#define BALANCE_SWEEP(dn, dd, gn, gd)                                                            \
+    BALANCE_BENCHMARK(balance_insert, dn, dd, gn, gd);                                           \
+    BALANCE_BENCHMARK(balance_find, dn, dd, gn, gd);                                             \
+    BALANCE_BENCHMARK(balance_remove, dn, dd, gn, gd)
+
+BALANCE_SWEEP(5, 2, 3, 2);
+BALANCE_SWEEP(3, 1, 3, 2);
+BALANCE_SWEEP(3, 1, 2, 1);
+BALANCE_SWEEP(7, 2, 2, 1);
+BALANCE_SWEEP(7, 2, 5, 2);
+
+// A "less" of the names, the equivalence is detected by two calls.
+struct str_apple_less {
+    using is_transparent = void;
+
+    template <typename A, typename B>
+    bool operator()(const A& a, const B& b) const noexcept {
+        return str_apple_compare::key(a) < str_apple_compare::key(b);
+    }
+};
+
+// The names share a long prefix, so each comparison of strings is expensive.
+static std::vector<str_apple> generate_names(uint32_t seed, uint32_t size) {
+    std::vector<str_apple> v;
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<uint32_t> dis(0, UINT32_MAX);
+    v.reserve(size);
+    for (size_t i = 0; i < size; ++i) {
+        v.emplace_back("/tenants/00000042/sessions/" + std::to_string(dis(gen)), i);
+    }
+    return v;
+}
+
+template <typename Tree>
+static void string_find(benchmark::State& state) {
+    std::size_t size = state.range(0);
+    auto&& data = generate_names(23, size);
+    Tree tree{};
+
+    for (auto& e: data) {
+        tree.insert_multi(&e);
+    }
+    perf_scope perf(state);
+    for (auto _: state) {
+        for (auto& e: data) {
+            benchmark::DoNotOptimize(tree.find(std::string_view(e.name)));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * size);
+}
+
+template <typename Tree>
+static void string_insert_remove(benchmark::State& state) {
+    std::size_t size = state.range(0);
+    auto&& data = generate_names(23, size);
+    Tree tree{};
+
+    perf_scope perf(state);
+    for (auto _: state) {
+        for (auto& e: data) {
+            tree.insert(&e);
+        }
+        for (auto& e: data) {
+            benchmark::DoNotOptimize(tree.remove(std::string_view(e.name)));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * size);
+}
+
+using irwbt_str_less_t =
+    uit::irwbt<&str_apple::right, &str_apple::left, &str_apple::size, str_apple_less>;
+using irwbt_str_compare_t =
+    uit::irwbt<&str_apple::right, &str_apple::left, &str_apple::size, str_apple_compare>;
+
+BENCHMARK(string_find<irwbt_str_less_t>)->Name("irwbt_string_find_less")->Range(1 << 10, 1 << 18);
+BENCHMARK(string_find<irwbt_str_compare_t>)
+    ->Name("irwbt_string_find_three_way")
+    ->Range(1 << 10, 1 << 18);
+BENCHMARK(string_insert_remove<irwbt_str_less_t>)
+    ->Name("irwbt_string_insert_remove_less")
+    ->Range(1 << 10, 1 << 18);
+BENCHMARK(string_insert_remove<irwbt_str_compare_t>)
+    ->Name("irwbt_string_insert_remove_three_way")
+    ->Range(1 << 10, 1 << 18);
+
+// The first argument is the size of the aggregator, and the second one is the size of the shard
+// merged into it. The trees are rebuilt out of the timing, so the iterations are limited.
+template <bool Drain>
+static void merge(benchmark::State& state) {
+    std::size_t n = state.range(0);
+    std::size_t m = state.range(1);
+    auto&& data = generate_apples<rsbt_apple>(23, n + m);
+    irwbt_apple_t a{};
+    irwbt_apple_t b{};
+
+    perf_scope perf(state);
+    for (auto _: state) {
+        perf.pause_timing();
+        a.clear();
+        for (std::size_t i = 0; i < n + m; i++) {
+            (i < n ? a : b).insert_multi(&data[i]);
+        }
+        perf.resume_timing();
+        if constexpr (Drain) {
+            while (!b.empty()) {
+                a.insert_multi(b.remove_leftmost());
+            }
+        } else {
+            a.merge(b);
+        }
+        benchmark::DoNotOptimize(a.size());
+    }
+    state.SetItemsProcessed(state.iterations() * m);
+}
+
+BENCHMARK(merge<true>)
+    ->Name("irwbt_merge_drain")
+    ->ArgsProduct({{1 << 18}, {1 << 4, 1 << 10, 1 << 14, 1 << 18}})
+    ->Args({1 << 4, 1 << 18})
+    ->Iterations(32);
+BENCHMARK(merge<false>)
+    ->Name("irwbt_merge_join")
+    ->ArgsProduct({{1 << 18}, {1 << 4, 1 << 10, 1 << 14, 1 << 18}})
+    ->Args({1 << 4, 1 << 18})
+    ->Iterations(32);
+
+// The second argument is the distribution of the keys, see common/workload.hpp.
+static void irwbt_insert_find_keys(benchmark::State& state) {
+    std::size_t size = state.range(0);
+    auto kind = static_cast<keys>(state.range(1));
+    auto&& data = generate_apples<rsbt_apple>(23, size, kind);
+    irwbt_apple_t tree{};
+
+    perf_scope perf(state);
+    for (auto _: state) {
+        for (auto& e: data) {
+            tree.insert_multi(&e);
+        }
+        for (auto& e: data) {
+            benchmark::DoNotOptimize(tree.find(e.weight));
+        }
+        tree.clear();
+    }
+    state.SetItemsProcessed(state.iterations() * size * 2);
+    state.SetLabel(keys_name(kind));
+}
+
+BENCHMARK(irwbt_insert_find_keys)
+    ->ArgsProduct({{1 << 10, 1 << 18}, benchmark::CreateDenseRange(0, keys_count - 1, 1)});
+
+// Replay a mixed trace over a pool of 64K nodes, half of them are in the tree at the beginning.
+// The arguments are the percentages of insertions and erasures, the rest are lookups, and the third
+// one is the distribution of the keys.
+static void irwbt_trace(benchmark::State& state) {
+    const uint32_t size = 1 << 16;
+    const uint32_t trace_size = 1 << 18;
+    auto kind = static_cast<keys>(state.range(2));
+    auto&& data = generate_apples<rsbt_apple>(23, size, kind);
+    auto&& trace = generate_trace(29, size, size / 2, trace_size, state.range(0), state.range(1));
+    irwbt_apple_t tree{};
+
+    perf_scope perf(state);
+    for (auto _: state) {
+        perf.pause_timing();
+        tree.clear();
+        for (uint32_t i = 0; i < size / 2; i++) {
+            tree.insert_multi(&data[i]);
+        }
+        perf.resume_timing();
+        for (auto& o: trace) {
+            rsbt_apple& e = data[o.index];
+            switch (o.kind) {
+            case op::insert:
+                tree.insert_multi(&e);
+                break;
+            case op::erase:
+                tree.erase(&e);
+                break;
+            default:
+                benchmark::DoNotOptimize(tree.find(e.weight));
+                break;
+            }
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * trace_size);
+    state.SetLabel(keys_name(kind));
+}
+
+BENCHMARK(irwbt_trace)->ArgsProduct(
+    {{10, 40}, {10, 40}, {int(keys::uniform), int(keys::zipf), int(keys::duplicates)}});
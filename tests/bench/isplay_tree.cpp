@@ -0,0 +1,49 @@
+// SPDX-FileCopyrightText: 2025 TypeCombinator <typecombinator@foxmail.com>
+//
+// SPDX-License-Identifier: BSD 3-Clause
+
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <vector>
+#include <random>
+#include <common/apple.hpp>
+#include <common/workload.hpp>
+#include <common/perf_counters.hpp>
+#include <uit/isplay_tree.hpp>
+#include <uit/irwbt.hpp>
+#include <uit/irbt.hpp>
+
+using isplay_apple_t = uit::isplay_tree<&rsbt_apple::right, &rsbt_apple::left>;
+using irwbt_apple_t = uit::irwbt<&rsbt_apple::right, &rsbt_apple::left, &rsbt_apple::size>;
+using irbt_apple_t =
+    uit::irbt<&rbt_apple::right, &rbt_apple::left, &rbt_apple::parent, &rbt_apple::color>;
+
+// The first argument is the number of nodes, the second one is theta * 100 of the Zipf trace.
+template <typename Tree, typename Apple>
+static void find_zipf(benchmark::State& state) {
+    const uint32_t trace_size = 1 << 16;
+    uint32_t size = state.range(0);
+    auto&& data = generate_apples<Apple>(23, size, keys::permutation);
+    auto&& trace = generate_zipf_trace(29, size, trace_size, state.range(1) / 100.0);
+    Tree tree{};
+
+    for (auto& e: data) {
+        tree.insert_multi(&e);
+    }
+    perf_scope perf(state);
+    for (auto _: state) {
+        for (auto k: trace) {
+            benchmark::DoNotOptimize(tree.find(static_cast<uint64_t>(k)));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * trace_size);
+}
+
+#define FIND_ZIPF_BENCHMARK(tree, apple)                                                         \
+    BENCHMARK(find_zipf<tree, apple>)                                                            \
+        ->Name(#tree "/find_zipf")                                                               \
+        ->ArgsProduct({{1 << 14, 1 << 20}, {0, 99, 120}})
+
+FIND_ZIPF_BENCHMARK(isplay_apple_t, rsbt_apple);
+FIND_ZIPF_BENCHMARK(irwbt_apple_t, rsbt_apple);
+FIND_ZIPF_BENCHMARK(irbt_apple_t, rbt_apple);
@@ -0,0 +1,90 @@
+// SPDX-FileCopyrightText: 2025 TypeCombinator <typecombinator@foxmail.com>
+//
+// SPDX-License-Identifier: BSD 3-Clause
+
+#include <benchmark/benchmark.h>
+#include <vector>
+#include <random>
+#include <common/apple.hpp>
+#include <common/workload.hpp>
+#include <common/perf_counters.hpp>
+#include <uit/izip_tree.hpp>
+#include <uit/irwbt.hpp>
+
+using izip_apple_t = uit::izip_tree<&zip_apple::right, &zip_apple::left, &zip_apple::rank>;
+using izip_size_apple_t = uit::izip_tree<
+    &zip_apple::right,
+    &zip_apple::left,
+    &zip_apple::rank,
+    std::less<>,
+    &zip_apple::size>;
+using irwbt_apple_t = uit::irwbt<&rsbt_apple::right, &rsbt_apple::left, &rsbt_apple::size>;
+
+template <typename Tree, typename Apple>
+static void insert_multi(benchmark::State& state) {
+    std::size_t size = state.range(0);
+    auto&& data = generate_apples<Apple>(23, size, static_cast<keys>(state.range(1)));
+    Tree tree{};
+
+    perf_scope perf(state);
+    for (auto _: state) {
+        for (auto& e: data) {
+            tree.insert_multi(&e);
+        }
+        tree.clear();
+    }
+    state.SetItemsProcessed(state.iterations() * size);
+}
+
+template <typename Tree, typename Apple>
+static void insert_remove_leftmost(benchmark::State& state) {
+    std::size_t size = state.range(0);
+    auto&& data = generate_apples<Apple>(23, size, static_cast<keys>(state.range(1)));
+    Tree tree{};
+
+    perf_scope perf(state);
+    for (auto _: state) {
+        for (auto& e: data) {
+            tree.insert_multi(&e);
+        }
+        while (!tree.empty()) {
+            benchmark::DoNotOptimize(tree.remove_leftmost());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * size);
+}
+
+template <typename Tree, typename Apple>
+static void find(benchmark::State& state) {
+    std::size_t size = state.range(0);
+    auto&& data = generate_apples<Apple>(23, size, static_cast<keys>(state.range(1)));
+    Tree tree{};
+
+    for (auto& e: data) {
+        tree.insert_multi(&e);
+    }
+    perf_scope perf(state);
+    for (auto _: state) {
+        for (auto& e: data) {
+            benchmark::DoNotOptimize(tree.find(e.weight));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * size);
+}
+
+// The second argument is the distribution of the keys.
+#define ZIP_TREE_BENCHMARK(func, tree, apple)                                                    \
+    BENCHMARK(func<tree, apple>)                                                                 \
+        ->Name(#tree "/" #func)                                                                  \
+        ->ArgsProduct(                                                                           \
+            {{1 << 10, 1 << 14, 1 << 18},                                                        \
+             {int(keys::sorted), int(keys::uniform), int(keys::zigzag)}})
+
+ZIP_TREE_BENCHMARK(insert_multi, izip_apple_t, zip_apple);
+ZIP_TREE_BENCHMARK(insert_multi, izip_size_apple_t, zip_apple);
+ZIP_TREE_BENCHMARK(insert_multi, irwbt_apple_t, rsbt_apple);
+ZIP_TREE_BENCHMARK(insert_remove_leftmost, izip_apple_t, zip_apple);
+ZIP_TREE_BENCHMARK(insert_remove_leftmost, izip_size_apple_t, zip_apple);
+ZIP_TREE_BENCHMARK(insert_remove_leftmost, irwbt_apple_t, rsbt_apple);
+ZIP_TREE_BENCHMARK(find, izip_apple_t, zip_apple);
+ZIP_TREE_BENCHMARK(find, irwbt_apple_t, rsbt_apple);
@@ -0,0 +1,282 @@
+// SPDX-FileCopyrightText: 2025 TypeCombinator <typecombinator@foxmail.com>
+//
+// SPDX-License-Identifier: BSD 3-Clause
+
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <queue>
+#include <random>
+#include <set>
+#include <type_traits>
+#include <vector>
+#include <common/apple.hpp>
+#include <common/latency.hpp>
+#include <common/workload.hpp>
+#include <uit/idlist.hpp>
+#include <uit/iiqheap.hpp>
+#include <uit/irbt.hpp>
+#include <uit/irheap.hpp>
+#include <uit/irsbt.hpp>
+#include <uit/irwbt.hpp>
+#include <uit/isplay_tree.hpp>
+#include <uit/izip_tree.hpp>
+
+// The latency distribution of single operations, each one is timed alone, so the spikes that the
+// averages hide are visible, such as the growth of iiqheap and the rebalancing of the trees. The
+// percentiles of the timed operation are reported in nanoseconds, see common/latency.hpp. The time
+// of a benchmark includes the setup, so it's meaningless. The insertion is the push of the heaps.
+
+// The nodes are inserted in the order of the pool, and the removal takes a random order. The
+// adapters are allocated on the heap, since GCC warns about the mock head of a list on the stack
+// (-Warray-bounds).
+template <typename Container, typename Node, bool Reserved = false>
+struct intrusive_adapter {
+    using node_t = Node;
+
+    explicit intrusive_adapter(std::size_t size)
+        : c{make(size)} {
+    }
+
+    // iiqheap starts small and grows by doubling unless it's reserved.
+    static Container make(std::size_t size) {
+        if constexpr (std::is_constructible_v<Container, uint32_t>) {
+            return Container(Reserved ? static_cast<uint32_t>(size) : 16u);
+        } else {
+            return Container{};
+        }
+    }
+
+    void insert(Node *node) {
+        if constexpr (requires { c.insert_multi(node); }) {
+            c.insert_multi(node);
+        } else if constexpr (requires { c.push(node); }) {
+            c.push(node);
+        } else {
+            c.push_back(node);
+        }
+    }
+
+    // The trees without parent pointers remove an equivalent node by the key.
+    void remove(Node *node) {
+        if constexpr (requires { c.erase(node); }) {
+            c.erase(node);
+        } else if constexpr (requires { c.remove_leftmost(); }) {
+            c.remove(*node);
+        } else {
+            c.remove(node);
+        }
+    }
+
+    void pop() {
+        if constexpr (requires { c.remove_leftmost(); }) {
+            c.remove_leftmost();
+        } else {
+            c.pop();
+        }
+    }
+
+    Container c;
+};
+
+struct std_multiset {
+    using node_t = rsbt_apple;
+
+    explicit std_multiset(std::size_t size)
+        : positions(size) {
+    }
+
+    void insert(rsbt_apple *node) {
+        positions[node->sn] = c.insert(node->weight);
+    }
+
+    void remove(rsbt_apple *node) {
+        c.erase(positions[node->sn]);
+    }
+
+    void pop() {
+        c.erase(c.begin());
+    }
+
+    std::multiset<uint64_t> c;
+    std::vector<std::multiset<uint64_t>::iterator> positions;
+};
+
+struct std_list {
+    using node_t = rsbt_apple;
+
+    explicit std_list(std::size_t size)
+        : positions(size) {
+    }
+
+    void insert(rsbt_apple *node) {
+        positions[node->sn] = c.insert(c.end(), node->weight);
+    }
+
+    void remove(rsbt_apple *node) {
+        c.erase(positions[node->sn]);
+    }
+
+    std::list<uint64_t> c;
+    std::vector<std::list<uint64_t>::iterator> positions;
+};
+
+struct std_priority_queue {
+    using node_t = rsbt_apple;
+
+    explicit std_priority_queue(std::size_t) {
+    }
+
+    void insert(rsbt_apple *node) {
+        c.push(node->weight);
+    }
+
+    void pop() {
+        c.pop();
+    }
+
+    std::priority_queue<uint64_t, std::vector<uint64_t>, std::greater<>> c;
+};
+
+using irheap_t = intrusive_adapter<uit::irheap<&heap_apple::right, &heap_apple::left>, heap_apple>;
+using iiqheap_t = intrusive_adapter<uit::iiqheap<&heap_apple::index>, heap_apple>;
+using iiqheap_reserved_t = intrusive_adapter<uit::iiqheap<&heap_apple::index>, heap_apple, true>;
+using iiqheap_segmented_t = intrusive_adapter<
+    uit::iiqheap<&heap_apple::index, std::less<>, uit::segmented<std::allocator<heap_apple *>>>,
+    heap_apple>;
+using iiqheap_key_t = intrusive_adapter<
+    uit::iiqheap<
+        &heap_apple::index,
+        std::less<>,
+        uit::key_inline<std::allocator<heap_apple *>, &heap_apple::weight>>,
+    heap_apple>;
+using irsbt_t = intrusive_adapter<
+    uit::irsbt<&rsbt_apple::right, &rsbt_apple::left, &rsbt_apple::size>,
+    rsbt_apple>;
+using irwbt_t = intrusive_adapter<
+    uit::irwbt<&rsbt_apple::right, &rsbt_apple::left, &rsbt_apple::size>,
+    rsbt_apple>;
+using irbt_t = intrusive_adapter<
+    uit::irbt<&rbt_apple::right, &rbt_apple::left, &rbt_apple::parent, &rbt_apple::color>,
+    rbt_apple>;
+using izip_tree_t = intrusive_adapter<
+    uit::izip_tree<&zip_apple::right, &zip_apple::left, &zip_apple::rank>,
+    zip_apple>;
+using isplay_tree_t =
+    intrusive_adapter<uit::isplay_tree<&rsbt_apple::right, &rsbt_apple::left>, rsbt_apple>;
+using idlist_t = intrusive_adapter<uit::idlist<&list_apple::right, &list_apple::left>, list_apple>;
+
+template <typename Adapter>
+static void latency_insert(benchmark::State &state) {
+    std::size_t size = state.range(0);
+    auto &&data = generate_apples<typename Adapter::node_t>(23, size);
+    latency_histogram<> histogram;
+
+    for (auto _: state) {
+        auto a_ptr = std::make_unique<Adapter>(size);
+        Adapter &a = *a_ptr;
+        for (auto &e: data) {
+            histogram.time([&a, &e] { a.insert(&e); });
+        }
+        benchmark::DoNotOptimize(&a);
+    }
+    histogram.report(state);
+    state.SetItemsProcessed(state.iterations() * size);
+}
+
+template <typename Adapter>
+static void latency_remove(benchmark::State &state) {
+    std::size_t size = state.range(0);
+    auto &&data = generate_apples<typename Adapter::node_t>(23, size);
+    std::vector<typename Adapter::node_t *> order;
+    for (auto &e: data) {
+        order.push_back(&e);
+    }
+    std::shuffle(order.begin(), order.end(), std::mt19937(29));
+    latency_histogram<> histogram;
+
+    for (auto _: state) {
+        auto a_ptr = std::make_unique<Adapter>(size);
+        Adapter &a = *a_ptr;
+        for (auto &e: data) {
+            a.insert(&e);
+        }
+        for (auto e: order) {
+            histogram.time([&a, e] { a.remove(e); });
+        }
+        benchmark::DoNotOptimize(&a);
+    }
+    histogram.report(state);
+    state.SetItemsProcessed(state.iterations() * size);
+}
+
+template <typename Adapter>
+static void latency_pop(benchmark::State &state) {
+    std::size_t size = state.range(0);
+    auto &&data = generate_apples<typename Adapter::node_t>(23, size);
+    latency_histogram<> histogram;
+
+    for (auto _: state) {
+        auto a_ptr = std::make_unique<Adapter>(size);
+        Adapter &a = *a_ptr;
+        for (auto &e: data) {
+            a.insert(&e);
+        }
+        for (std::size_t i = 0; i < size; i++) {
+            histogram.time([&a] { a.pop(); });
+        }
+        benchmark::DoNotOptimize(&a);
+    }
+    histogram.report(state);
+    state.SetItemsProcessed(state.iterations() * size);
+}
+
+#define LATENCY_BENCHMARK(op, adapter)                                                             \
+    BENCHMARK(latency_##op<adapter>)                                                               \
+        ->Name(#adapter "/" #op)                                                                   \
+        ->Iterations(4)                                                                            \
+        ->Arg(1 << 12)                                                                             \
+        ->Arg(1 << 16)                                                                             \
+        ->Arg(1 << 20)
+
+LATENCY_BENCHMARK(insert, irheap_t);
+LATENCY_BENCHMARK(insert, iiqheap_t);
+LATENCY_BENCHMARK(insert, iiqheap_reserved_t);
+LATENCY_BENCHMARK(insert, iiqheap_segmented_t);
+LATENCY_BENCHMARK(insert, iiqheap_key_t);
+LATENCY_BENCHMARK(insert, std_priority_queue);
+LATENCY_BENCHMARK(insert, irsbt_t);
+LATENCY_BENCHMARK(insert, irwbt_t);
+LATENCY_BENCHMARK(insert, irbt_t);
+LATENCY_BENCHMARK(insert, izip_tree_t);
+LATENCY_BENCHMARK(insert, isplay_tree_t);
+LATENCY_BENCHMARK(insert, std_multiset);
+LATENCY_BENCHMARK(insert, idlist_t);
+LATENCY_BENCHMARK(insert, std_list);
+
+LATENCY_BENCHMARK(pop, irheap_t);
+LATENCY_BENCHMARK(pop, iiqheap_t);
+LATENCY_BENCHMARK(pop, iiqheap_segmented_t);
+LATENCY_BENCHMARK(pop, iiqheap_key_t);
+LATENCY_BENCHMARK(pop, std_priority_queue);
+LATENCY_BENCHMARK(pop, irsbt_t);
+LATENCY_BENCHMARK(pop, irwbt_t);
+LATENCY_BENCHMARK(pop, irbt_t);
+LATENCY_BENCHMARK(pop, izip_tree_t);
+LATENCY_BENCHMARK(pop, isplay_tree_t);
+LATENCY_BENCHMARK(pop, std_multiset);
+
+LATENCY_BENCHMARK(remove, iiqheap_t);
+LATENCY_BENCHMARK(remove, iiqheap_segmented_t);
+LATENCY_BENCHMARK(remove, iiqheap_key_t);
+LATENCY_BENCHMARK(remove, irsbt_t);
+LATENCY_BENCHMARK(remove, irwbt_t);
+LATENCY_BENCHMARK(remove, irbt_t);
+LATENCY_BENCHMARK(remove, izip_tree_t);
+LATENCY_BENCHMARK(remove, isplay_tree_t);
+LATENCY_BENCHMARK(remove, std_multiset);
+LATENCY_BENCHMARK(remove, idlist_t);
+LATENCY_BENCHMARK(remove, std_list);
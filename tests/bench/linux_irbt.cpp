@@ -6,6 +6,8 @@
 #include <vector>
 #include <random>
 #include "common/linux_irbt.h"
+#include <common/workload.hpp>
+#include <common/perf_counters.hpp>
 
 #define container_of(_ptr_, _type_, _member_)                                                      \
     ((_type_ *) ((unsigned char *) (_ptr_) - offsetof(_type_, _member_)))
@@ -54,24 +56,29 @@ static void linux_irbt_erase(rb_root *root, const linux_rbt_apple *node) {
     }
 }
 
-// TODO: need a generic generator.
-static std::vector<linux_rbt_apple>
-    generate_random_vector(uint32_t seed, uint32_t size, uint32_t dis_a, uint32_t dis_b) {
-    std::vector<linux_rbt_apple> v;
-    std::mt19937 gen(seed);
-    std::uniform_int_distribution<uint32_t> dis(dis_a, dis_b);
-    v.reserve(size);
-    for (size_t i = 0; i < size; ++i) {
-        v.emplace_back(dis(gen), i);
+static linux_rbt_apple *linux_irbt_find(const rb_root *root, const linux_rbt_apple *node) {
+    rb_node *cur = root->rb_node;
+    linux_rbt_apple *cur_container;
+
+    while (cur != NULL) {
+        cur_container = container_of(cur, linux_rbt_apple, node);
+        if (node->weight < cur_container->weight) {
+            cur = cur->rb_left;
+        } else if (cur_container->weight < node->weight) {
+            cur = cur->rb_right;
+        } else {
+            return cur_container;
+        }
     }
-    return v;
+    return NULL;
 }
 
 static void linux_irbt_insert_multi_random(benchmark::State &state) {
     std::size_t size = state.range(0);
-    auto &&data = generate_random_vector(23, size, 0, size * 8);
+    auto &&data = generate_apples<linux_rbt_apple>(23, size);
     rb_root tree = {NULL};
 
+    perf_scope perf(state);
     for (auto _: state) {
         for (auto &i: data) {
             linux_irbt_insert(&tree, &i);
@@ -86,15 +93,16 @@ BENCHMARK(linux_irbt_insert_multi_random)->RangeMultiplier(2)->Range(1 << 10, 1
 
 static void linux_irbt_erase_random(benchmark::State &state) {
     std::size_t size = state.range(0);
-    auto &&data = generate_random_vector(23, size, 0, size * 8);
+    auto &&data = generate_apples<linux_rbt_apple>(23, size);
     rb_root tree = {NULL};
 
+    perf_scope perf(state);
     for (auto _: state) {
-        state.PauseTiming();
+        perf.pause_timing();
         for (auto &e: data) {
             linux_irbt_insert(&tree, &e);
         }
-        state.ResumeTiming();
+        perf.resume_timing();
 
         for (const auto &e: data) {
             linux_irbt_erase(&tree, &e);
@@ -107,4 +115,44 @@ static void linux_irbt_erase_random(benchmark::State &state) {
     state.SetComplexityN(state.range(0));
 }
 
-BENCHMARK(linux_irbt_erase_random)->RangeMultiplier(2)->Range(1 << 10, 1 << 18)->Complexity();
\ No newline at end of file
+BENCHMARK(linux_irbt_erase_random)->RangeMultiplier(2)->Range(1 << 10, 1 << 18)->Complexity();
+
+static void linux_irbt_find_random(benchmark::State &state) {
+    std::size_t size = state.range(0);
+    auto &&data = generate_apples<linux_rbt_apple>(23, size);
+    rb_root tree = {NULL};
+
+    for (auto &e: data) {
+        linux_irbt_insert(&tree, &e);
+    }
+    perf_scope perf(state);
+    for (auto _: state) {
+        for (const auto &e: data) {
+            benchmark::DoNotOptimize(linux_irbt_find(&tree, &e));
+        }
+    }
+    state.SetComplexityN(state.range(0));
+}
+
+BENCHMARK(linux_irbt_find_random)->RangeMultiplier(2)->Range(1 << 10, 1 << 18)->Complexity();
+// The second argument is theta * 100 of the Zipf trace.
+static void linux_irbt_find_zipf(benchmark::State &state) {
+    const uint32_t trace_size = 1 << 16;
+    std::size_t size = state.range(0);
+    auto &&data = generate_apples<linux_rbt_apple>(23, size);
+    auto &&trace = generate_zipf_trace(29, size, trace_size, state.range(1) / 100.0);
+    rb_root tree = {NULL};
+
+    for (auto &e: data) {
+        linux_irbt_insert(&tree, &e);
+    }
+    perf_scope perf(state);
+    for (auto _: state) {
+        for (auto k: trace) {
+            benchmark::DoNotOptimize(linux_irbt_find(&tree, &data[k]));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * trace_size);
+}
+
+BENCHMARK(linux_irbt_find_zipf)->ArgsProduct({{1 << 14, 1 << 20}, {0, 99, 120}});
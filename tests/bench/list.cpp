@@ -0,0 +1,486 @@
+// SPDX-FileCopyrightText: 2025 TypeCombinator <typecombinator@foxmail.com>
+//
+// SPDX-License-Identifier: BSD 3-Clause
+
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <forward_list>
+#include <list>
+#include <memory>
+#include <random>
+#include <type_traits>
+#include <vector>
+#include <common/apple.hpp>
+#include <common/workload.hpp>
+#include <common/perf_counters.hpp>
+#include <uit/islist.hpp>
+#include <uit/isdlist.hpp>
+#include <uit/idslist.hpp>
+#include <uit/idlist.hpp>
+#if __has_include(<boost/intrusive/list.hpp>)
+#include <boost/intrusive/list.hpp>
+#include <boost/intrusive/slist.hpp>
+#define UIT_BENCH_HAS_BOOST_INTRUSIVE 1
+#endif
+
+// The baselines of the lists: the hand-written C lists with a pointer-to-pointer head, the standard
+// containers and boost.intrusive. Each benchmark reports the time per operation in "op".
+
+using islist_t = uit::islist<&list_apple::right>;
+using isdlist_t = uit::isdlist<&list_apple::right, &list_apple::left>;
+using idslist_t = uit::idslist<&list_apple::right>;
+using idlist_t = uit::idlist<&list_apple::right, &list_apple::left>;
+
+template <typename Node>
+struct node_iterator {
+    Node *cur;
+
+    Node &operator*() const noexcept {
+        return *cur;
+    }
+
+    node_iterator &operator++() noexcept {
+        cur = cur->right;
+        return *this;
+    }
+
+    bool operator==(const node_iterator &other) const noexcept {
+        return cur == other.cur;
+    }
+};
+
+// A singly linked list, the removal walks the links by a pointer to pointer.
+struct c_slist {
+    list_apple *head = nullptr;
+
+    void push_front(list_apple *node) noexcept {
+        node->right = head;
+        head = node;
+    }
+
+    list_apple *pop_front() noexcept {
+        list_apple *first = head;
+        if (first != nullptr) {
+            head = first->right;
+        }
+        return first;
+    }
+
+    list_apple *remove(list_apple *node) noexcept {
+        for (list_apple **cur = &head; *cur != nullptr; cur = &((*cur)->right)) {
+            if (*cur == node) {
+                *cur = node->right;
+                return node;
+            }
+        }
+        return nullptr;
+    }
+
+    node_iterator<list_apple> begin() const noexcept {
+        return {head};
+    }
+
+    node_iterator<list_apple> end() const noexcept {
+        return {nullptr};
+    }
+};
+
+// A FIFO queue, the tail is the pointer to the last link, so the empty queue is a special case.
+struct c_queue {
+    list_apple *head = nullptr;
+    list_apple **tail = &head;
+
+    void push_back(list_apple *node) noexcept {
+        node->right = nullptr;
+        *tail = node;
+        tail = &(node->right);
+    }
+
+    list_apple *pop_front() noexcept {
+        list_apple *first = head;
+        if (first != nullptr) {
+            head = first->right;
+            if (head == nullptr) {
+                tail = &head;
+            }
+        }
+        return first;
+    }
+
+    void splice_back(c_queue &other) noexcept {
+        if (other.head == nullptr) {
+            return;
+        }
+        *tail = other.head;
+        tail = other.tail;
+        other.head = nullptr;
+        other.tail = &other.head;
+    }
+
+    node_iterator<list_apple> begin() const noexcept {
+        return {head};
+    }
+
+    node_iterator<list_apple> end() const noexcept {
+        return {nullptr};
+    }
+};
+
+// The hlist of linux, "left" is the pointer to the link that points to the node.
+struct c_hlist {
+    list_apple *head = nullptr;
+
+    void push_front(list_apple *node) noexcept {
+        node->right = head;
+        if (head != nullptr) {
+            head->left = reinterpret_cast<list_apple *>(&(node->right));
+        }
+        head = node;
+        node->left = reinterpret_cast<list_apple *>(&head);
+    }
+
+    static void remove(list_apple *node) noexcept {
+        list_apple **pprev = reinterpret_cast<list_apple **>(node->left);
+        list_apple *next = node->right;
+        *pprev = next;
+        if (next != nullptr) {
+            next->left = reinterpret_cast<list_apple *>(pprev);
+        }
+    }
+
+    node_iterator<list_apple> begin() const noexcept {
+        return {head};
+    }
+
+    node_iterator<list_apple> end() const noexcept {
+        return {nullptr};
+    }
+};
+
+// The standard containers own the values, so each push allocates.
+struct std_forward_list {
+    std::forward_list<uint64_t> list;
+
+    void push_front(list_apple *node) {
+        list.push_front(node->weight);
+    }
+
+    uint64_t pop_front() noexcept {
+        uint64_t v = list.front();
+        list.pop_front();
+        return v;
+    }
+
+    auto begin() const noexcept {
+        return list.begin();
+    }
+
+    auto end() const noexcept {
+        return list.end();
+    }
+};
+
+struct std_list {
+    std::list<uint64_t> list;
+
+    void push_front(list_apple *node) {
+        list.push_front(node->weight);
+    }
+
+    void push_back(list_apple *node) {
+        list.push_back(node->weight);
+    }
+
+    uint64_t pop_front() noexcept {
+        uint64_t v = list.front();
+        list.pop_front();
+        return v;
+    }
+
+    void splice_back(std_list &other) noexcept {
+        list.splice(list.end(), other.list);
+    }
+
+    auto begin() const noexcept {
+        return list.begin();
+    }
+
+    auto end() const noexcept {
+        return list.end();
+    }
+};
+
+#ifdef UIT_BENCH_HAS_BOOST_INTRUSIVE
+struct boost_apple {
+    explicit boost_apple(uint64_t weight, int sn) noexcept
+        : weight(weight)
+        , sn(sn) {
+    }
+
+    uint64_t weight;
+    boost::intrusive::list_member_hook<boost::intrusive::link_mode<boost::intrusive::normal_link>>
+        list_hook;
+    boost::intrusive::slist_member_hook<boost::intrusive::link_mode<boost::intrusive::normal_link>>
+        slist_hook;
+    int sn;
+};
+
+using boost_list_t = boost::intrusive::list<
+    boost_apple,
+    boost::intrusive::member_hook<boost_apple, decltype(boost_apple::list_hook), &boost_apple::list_hook>,
+    boost::intrusive::constant_time_size<false>>;
+using boost_slist_t = boost::intrusive::slist<
+    boost_apple,
+    boost::intrusive::member_hook<boost_apple, decltype(boost_apple::slist_hook), &boost_apple::slist_hook>,
+    boost::intrusive::constant_time_size<false>,
+    boost::intrusive::cache_last<true>>;
+
+template <typename List>
+struct boost_adapter {
+    List list;
+
+    void push_front(boost_apple *node) noexcept {
+        list.push_front(*node);
+    }
+
+    void push_back(boost_apple *node) noexcept {
+        list.push_back(*node);
+    }
+
+    boost_apple *pop_front() noexcept {
+        boost_apple *first = &list.front();
+        list.pop_front();
+        return first;
+    }
+
+    void remove(boost_apple *node) noexcept {
+        list.erase(List::s_iterator_to(*node));
+    }
+
+    void splice_back(boost_adapter &other) noexcept {
+        if constexpr (std::is_same_v<List, boost_slist_t>) {
+            // The splice of slist at an iterator must find the previous node.
+            list.splice_after(list.empty() ? list.before_begin() : list.last(), other.list);
+        } else {
+            list.splice(list.end(), other.list);
+        }
+    }
+
+    auto begin() const noexcept {
+        return list.begin();
+    }
+
+    auto end() const noexcept {
+        return list.end();
+    }
+};
+
+using boost_list = boost_adapter<boost_list_t>;
+using boost_slist = boost_adapter<boost_slist_t>;
+#endif
+
+template <typename Node>
+struct node_of {
+    using type = list_apple;
+};
+
+#ifdef UIT_BENCH_HAS_BOOST_INTRUSIVE
+template <typename List>
+struct node_of<boost_adapter<List>> {
+    using type = boost_apple;
+};
+#endif
+
+template <typename List>
+using node_t = typename node_of<List>::type;
+
+static uint64_t weight_of(uint64_t v) noexcept {
+    return v;
+}
+
+template <typename Node>
+static uint64_t weight_of(const Node &node) noexcept {
+    return node.weight;
+}
+
+// The stores through the mock head may be missed by GCC when the list doesn't escape, even with
+// -fno-strict-aliasing, see the notice of mock_head in README.md. The list is allocated on the
+// heap, since GCC warns about the mock head of a list on the stack (-Warray-bounds).
+template <typename List>
+static std::unique_ptr<List> make_list() {
+    auto list = std::make_unique<List>();
+    benchmark::DoNotOptimize(list.get());
+    benchmark::ClobberMemory();
+    return list;
+}
+
+static void set_per_op(benchmark::State &state, std::size_t ops) {
+    state.SetItemsProcessed(state.iterations() * ops);
+    state.counters["op"] = benchmark::Counter(
+        static_cast<double>(ops),
+        benchmark::Counter::kIsIterationInvariantRate | benchmark::Counter::kInvert);
+}
+
+// Push all nodes to the front and pop them all, it's the LIFO stack.
+template <typename List>
+static void push_pop_front(benchmark::State &state) {
+    std::size_t size = state.range(0);
+    auto &&data = generate_apples<node_t<List>>(23, size);
+    auto list_ptr = make_list<List>();
+    List &list = *list_ptr;
+
+    perf_scope perf(state);
+    for (auto _: state) {
+        for (auto &e: data) {
+            list.push_front(&e);
+        }
+        for (std::size_t i = 0; i < size; i++) {
+            benchmark::DoNotOptimize(list.pop_front());
+        }
+    }
+    set_per_op(state, size * 2);
+}
+
+// The FIFO queue keeps "size" nodes, each operation pops the front and pushes it back.
+template <typename List>
+static void fifo(benchmark::State &state) {
+    std::size_t size = state.range(0);
+    auto &&data = generate_apples<node_t<List>>(23, size);
+    auto list_ptr = make_list<List>();
+    List &list = *list_ptr;
+
+    for (auto &e: data) {
+        list.push_back(&e);
+    }
+    perf_scope perf(state);
+    for (auto _: state) {
+        for (std::size_t i = 0; i < size; i++) {
+            auto node = list.pop_front();
+            if constexpr (std::is_pointer_v<decltype(node)>) {
+                list.push_back(node);
+            } else {
+                list.push_back(&data[i]);
+            }
+        }
+    }
+    set_per_op(state, size);
+}
+
+template <typename List>
+static void iterate(benchmark::State &state) {
+    std::size_t size = state.range(0);
+    auto &&data = generate_apples<node_t<List>>(23, size);
+    auto list_ptr = make_list<List>();
+    List &list = *list_ptr;
+
+    for (auto &e: data) {
+        list.push_front(&e);
+    }
+    perf_scope perf(state);
+    for (auto _: state) {
+        uint64_t sum = 0;
+        for (auto &e: list) {
+            sum += weight_of(e);
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    set_per_op(state, size);
+}
+
+// Remove all nodes in a random order and push them back, the singly linked lists must walk to the
+// node, so they're O(n) per removal.
+template <typename List>
+static void remove_random(benchmark::State &state) {
+    std::size_t size = state.range(0);
+    auto &&data = generate_apples<node_t<List>>(23, size);
+    std::vector<node_t<List> *> order;
+    auto list_ptr = make_list<List>();
+    List &list = *list_ptr;
+
+    for (auto &e: data) {
+        order.push_back(&e);
+    }
+    std::shuffle(order.begin(), order.end(), std::mt19937{29});
+    perf_scope perf(state);
+    for (auto _: state) {
+        perf.pause_timing();
+        for (auto &e: data) {
+            list.push_front(&e);
+        }
+        perf.resume_timing();
+        for (auto e: order) {
+            list.remove(e);
+        }
+    }
+    set_per_op(state, size);
+}
+
+// The nodes are spliced back and forth between two lists of "size / 2" nodes.
+template <typename List>
+static void splice(benchmark::State &state) {
+    std::size_t size = state.range(0);
+    auto &&data = generate_apples<node_t<List>>(23, size);
+    auto a_ptr = make_list<List>();
+    auto b_ptr = make_list<List>();
+    List &a = *a_ptr;
+    List &b = *b_ptr;
+
+    for (std::size_t i = 0; i < size; i++) {
+        (i % 2 == 0 ? a : b).push_back(&data[i]);
+    }
+    perf_scope perf(state);
+    for (auto _: state) {
+        a.splice_back(b);
+        b.splice_back(a);
+        benchmark::DoNotOptimize(&a);
+        benchmark::DoNotOptimize(&b);
+    }
+    set_per_op(state, 2);
+}
+
+#define LIST_BENCHMARK(func, list) BENCHMARK(func<list>)->Name(#list "/" #func)->Range(16, 1 << 16)
+
+LIST_BENCHMARK(push_pop_front, islist_t);
+LIST_BENCHMARK(push_pop_front, isdlist_t);
+LIST_BENCHMARK(push_pop_front, idslist_t);
+LIST_BENCHMARK(push_pop_front, idlist_t);
+LIST_BENCHMARK(push_pop_front, c_slist);
+LIST_BENCHMARK(push_pop_front, std_forward_list);
+LIST_BENCHMARK(push_pop_front, std_list);
+
+LIST_BENCHMARK(fifo, idslist_t);
+LIST_BENCHMARK(fifo, idlist_t);
+LIST_BENCHMARK(fifo, c_queue);
+LIST_BENCHMARK(fifo, std_list);
+
+LIST_BENCHMARK(iterate, islist_t);
+LIST_BENCHMARK(iterate, isdlist_t);
+LIST_BENCHMARK(iterate, idslist_t);
+LIST_BENCHMARK(iterate, idlist_t);
+LIST_BENCHMARK(iterate, c_slist);
+LIST_BENCHMARK(iterate, std_forward_list);
+LIST_BENCHMARK(iterate, std_list);
+
+LIST_BENCHMARK(remove_random, isdlist_t);
+LIST_BENCHMARK(remove_random, idlist_t);
+LIST_BENCHMARK(remove_random, c_hlist);
+BENCHMARK(remove_random<islist_t>)->Name("islist_t/remove_random")->Range(16, 1 << 10);
+BENCHMARK(remove_random<idslist_t>)->Name("idslist_t/remove_random")->Range(16, 1 << 10);
+BENCHMARK(remove_random<c_slist>)->Name("c_slist/remove_random")->Range(16, 1 << 10);
+
+LIST_BENCHMARK(splice, idslist_t);
+LIST_BENCHMARK(splice, idlist_t);
+LIST_BENCHMARK(splice, c_queue);
+LIST_BENCHMARK(splice, std_list);
+
+#ifdef UIT_BENCH_HAS_BOOST_INTRUSIVE
+LIST_BENCHMARK(push_pop_front, boost_slist);
+LIST_BENCHMARK(push_pop_front, boost_list);
+LIST_BENCHMARK(fifo, boost_slist);
+LIST_BENCHMARK(fifo, boost_list);
+LIST_BENCHMARK(iterate, boost_slist);
+LIST_BENCHMARK(iterate, boost_list);
+LIST_BENCHMARK(remove_random, boost_list);
+LIST_BENCHMARK(splice, boost_slist);
+LIST_BENCHMARK(splice, boost_list);
+#endif
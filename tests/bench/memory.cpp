@@ -0,0 +1,315 @@
+// SPDX-FileCopyrightText: 2025 TypeCombinator <typecombinator@foxmail.com>
+//
+// SPDX-License-Identifier: BSD 3-Clause
+
+#include <benchmark/benchmark.h>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <forward_list>
+#include <list>
+#include <memory>
+#include <queue>
+#include <set>
+#include <type_traits>
+#include <vector>
+#include <common/workload.hpp>
+#include <uit/idlist.hpp>
+#include <uit/idslist.hpp>
+#include <uit/iiqheap.hpp>
+#include <uit/irbt.hpp>
+#include <uit/irheap.hpp>
+#include <uit/irsbt.hpp>
+#include <uit/irwbt.hpp>
+#include <uit/isdlist.hpp>
+#include <uit/islist.hpp>
+#include <uit/isplay_tree.hpp>
+#include <uit/izip_tree.hpp>
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+#if __has_include(<unistd.h>)
+#include <unistd.h>
+#endif
+
+// The memory footprint of the containers, each one is built once with "size" nodes of 8-byte keys,
+// and the time is meaningless. The counters are per element:
+// - node_B: the size of the node, the key and the hooks. The std containers allocate their nodes.
+// - hook_B: the bytes the hooks add to the key, including the padding.
+// - aux_B: the memory owned by the container, such as the storage of iiqheap with its slack, the
+//   buckets of a hash table, and the allocations of the std containers.
+// - rss_B: the growth of the resident set while the nodes and the container are built, it includes
+//   the overhead of malloc, it's noisy for small sizes.
+
+struct key_node {
+    bool operator<(const key_node &other) const noexcept {
+        return key < other.key;
+    }
+
+    uint64_t key;
+};
+
+struct slist_node : key_node {
+    slist_node *right;
+};
+
+struct dlist_node : key_node {
+    dlist_node *right;
+    dlist_node *left;
+};
+
+struct index_node : key_node {
+    uint32_t index;
+};
+
+struct sbt_node : key_node {
+    sbt_node *right;
+    sbt_node *left;
+    std::size_t size;
+};
+
+struct rbt_node : key_node {
+    rbt_node *right;
+    rbt_node *left;
+    rbt_node *parent;
+    uint8_t color;
+};
+
+struct zip_node : key_node {
+    zip_node *right;
+    zip_node *left;
+    uint8_t rank;
+};
+
+// The bytes allocated by the std containers.
+static std::size_t allocated_bytes = 0;
+
+template <typename T>
+struct counting_allocator {
+    using value_type = T;
+
+    counting_allocator() noexcept = default;
+
+    template <typename U>
+    counting_allocator(const counting_allocator<U> &) noexcept {
+    }
+
+    T *allocate(std::size_t n) {
+        allocated_bytes += n * sizeof(T);
+        return std::allocator<T>{}.allocate(n);
+    }
+
+    void deallocate(T *p, std::size_t n) noexcept {
+        allocated_bytes -= n * sizeof(T);
+        std::allocator<T>{}.deallocate(p, n);
+    }
+
+    template <typename U>
+    bool operator==(const counting_allocator<U> &) const noexcept {
+        return true;
+    }
+};
+
+// Returns 0 if the resident set isn't available.
+static std::size_t rss_bytes() {
+    std::size_t pages = 0;
+    std::size_t resident = 0;
+    if (FILE *f = std::fopen("/proc/self/statm", "r")) {
+        if (std::fscanf(f, "%zu %zu", &pages, &resident) != 2) {
+            resident = 0;
+        }
+        std::fclose(f);
+    }
+#if __has_include(<unistd.h>)
+    return resident * static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+#else
+    return 0;
+#endif
+}
+
+// The container of intrusive nodes, the nodes are in a vector and inserted in its order.
+template <typename Node, typename Container>
+struct intrusive_case {
+    static constexpr std::size_t node_bytes = sizeof(Node);
+    static constexpr std::size_t hook_bytes = sizeof(Node) - sizeof(key_node);
+
+    explicit intrusive_case(const std::vector<uint64_t> &keys)
+        : nodes(keys.size())
+        , container{make()} {
+        for (std::size_t i = 0; i < keys.size(); i++) {
+            nodes[i].key = keys[i];
+            Node *node = &nodes[i];
+            if constexpr (requires { container.insert_multi(node); }) {
+                container.insert_multi(node);
+            } else if constexpr (requires { container.push(node); }) {
+                container.push(node);
+            } else if constexpr (requires { container.push_back(node); }) {
+                container.push_back(node);
+            } else {
+                container.push_front(node);
+            }
+        }
+    }
+
+    // iiqheap starts small and grows by doubling as usual, so the slack is included.
+    static Container make() {
+        if constexpr (std::is_constructible_v<Container, uint32_t>) {
+            return Container(16);
+        } else {
+            return Container{};
+        }
+    }
+
+    // A slot of iiqheap is a pointer, or the key and the pointer of the key-inline storage.
+    std::size_t aux_bytes() const noexcept {
+        if constexpr (requires { Container::slot_bytes; }) {
+            return container.capacity() * Container::slot_bytes;
+        } else {
+            return 0;
+        }
+    }
+
+    std::vector<Node> nodes;
+    Container container;
+};
+
+// A chained hash table of isdlist, the hlist of linux, with one bucket per node at most.
+struct isdlist_hash {
+    using list_t = uit::isdlist<&dlist_node::right, &dlist_node::left>;
+    static constexpr std::size_t node_bytes = sizeof(dlist_node);
+    static constexpr std::size_t hook_bytes = sizeof(dlist_node) - sizeof(key_node);
+
+    explicit isdlist_hash(const std::vector<uint64_t> &keys)
+        : nodes(keys.size())
+        , buckets(std::bit_ceil(keys.size())) {
+        std::size_t mask = buckets.size() - 1;
+        for (std::size_t i = 0; i < keys.size(); i++) {
+            nodes[i].key = keys[i];
+            buckets[(keys[i] * 0x9e3779b97f4a7c15u >> 32) & mask].push_front(&nodes[i]);
+        }
+    }
+
+    std::size_t aux_bytes() const noexcept {
+        return buckets.size() * sizeof(list_t);
+    }
+
+    std::vector<dlist_node> nodes;
+    std::vector<list_t> buckets;
+};
+
+// The std container of the keys, the nodes are allocated by the container.
+template <typename Container>
+struct std_case {
+    static constexpr std::size_t node_bytes = 0;
+    static constexpr std::size_t hook_bytes = 0;
+
+    explicit std_case(const std::vector<uint64_t> &keys)
+        : base{allocated_bytes} {
+        for (auto k: keys) {
+            if constexpr (requires { container.insert(k); }) {
+                container.insert(k);
+            } else if constexpr (requires { container.push(k); }) {
+                container.push(k);
+            } else {
+                container.push_front(k);
+            }
+        }
+    }
+
+    std::size_t aux_bytes() const noexcept {
+        return allocated_bytes - base;
+    }
+
+    std::size_t base;
+    Container container;
+};
+
+template <typename Case>
+static void footprint(benchmark::State &state) {
+    std::size_t size = state.range(0);
+    auto &&weights = generate_keys(23, size, keys::uniform);
+
+    for (auto _: state) {
+#if defined(__GLIBC__)
+        malloc_trim(0);
+#endif
+        std::size_t before = rss_bytes();
+        Case c(weights);
+        std::size_t after = rss_bytes();
+        benchmark::DoNotOptimize(&c);
+
+        auto n = static_cast<double>(size);
+        state.counters["node_B"] = static_cast<double>(Case::node_bytes);
+        state.counters["hook_B"] = static_cast<double>(Case::hook_bytes);
+        state.counters["aux_B"] = static_cast<double>(c.aux_bytes()) / n;
+        if ((before > 0) && (after > before)) {
+            state.counters["rss_B"] = static_cast<double>(after - before) / n;
+        }
+    }
+}
+
+template <typename T>
+using std_alloc_t = counting_allocator<T>;
+
+using islist_t = intrusive_case<slist_node, uit::islist<&slist_node::right>>;
+using idslist_t = intrusive_case<slist_node, uit::idslist<&slist_node::right>>;
+using isdlist_t = intrusive_case<dlist_node, uit::isdlist<&dlist_node::right, &dlist_node::left>>;
+using idlist_t = intrusive_case<dlist_node, uit::idlist<&dlist_node::right, &dlist_node::left>>;
+using irheap_t = intrusive_case<dlist_node, uit::irheap<&dlist_node::right, &dlist_node::left>>;
+using iiqheap_t = intrusive_case<index_node, uit::iiqheap<&index_node::index>>;
+using iiqheap_segmented_t = intrusive_case<
+    index_node,
+    uit::iiqheap<&index_node::index, std::less<>, uit::segmented<std::allocator<index_node *>>>>;
+using iiqheap_key_t = intrusive_case<
+    index_node,
+    uit::iiqheap<
+        &index_node::index,
+        std::less<>,
+        uit::key_inline<std::allocator<index_node *>, &index_node::key>>>;
+using irsbt_t =
+    intrusive_case<sbt_node, uit::irsbt<&sbt_node::right, &sbt_node::left, &sbt_node::size>>;
+using irwbt_t =
+    intrusive_case<sbt_node, uit::irwbt<&sbt_node::right, &sbt_node::left, &sbt_node::size>>;
+using irbt_t = intrusive_case<
+    rbt_node,
+    uit::irbt<&rbt_node::right, &rbt_node::left, &rbt_node::parent, &rbt_node::color>>;
+using izip_tree_t =
+    intrusive_case<zip_node, uit::izip_tree<&zip_node::right, &zip_node::left, &zip_node::rank>>;
+using isplay_tree_t =
+    intrusive_case<dlist_node, uit::isplay_tree<&dlist_node::right, &dlist_node::left>>;
+using std_forward_list = std_case<std::forward_list<uint64_t, std_alloc_t<uint64_t>>>;
+using std_list = std_case<std::list<uint64_t, std_alloc_t<uint64_t>>>;
+using std_multiset =
+    std_case<std::multiset<uint64_t, std::less<>, std_alloc_t<uint64_t>>>;
+using std_priority_queue = std_case<
+    std::priority_queue<uint64_t, std::vector<uint64_t, std_alloc_t<uint64_t>>, std::greater<>>>;
+
+#define MEMORY_BENCHMARK(container)                                                                \
+    BENCHMARK(footprint<container>)                                                                \
+        ->Name(#container "/footprint")                                                            \
+        ->Iterations(1)                                                                            \
+        ->Arg(1000)                                                                                \
+        ->Arg(1000000)                                                                             \
+        ->Arg(10000000)
+
+MEMORY_BENCHMARK(islist_t);
+MEMORY_BENCHMARK(idslist_t);
+MEMORY_BENCHMARK(isdlist_t);
+MEMORY_BENCHMARK(idlist_t);
+MEMORY_BENCHMARK(isdlist_hash);
+MEMORY_BENCHMARK(std_forward_list);
+MEMORY_BENCHMARK(std_list);
+
+MEMORY_BENCHMARK(irheap_t);
+MEMORY_BENCHMARK(iiqheap_t);
+MEMORY_BENCHMARK(iiqheap_segmented_t);
+MEMORY_BENCHMARK(iiqheap_key_t);
+MEMORY_BENCHMARK(std_priority_queue);
+
+MEMORY_BENCHMARK(irsbt_t);
+MEMORY_BENCHMARK(irwbt_t);
+MEMORY_BENCHMARK(irbt_t);
+MEMORY_BENCHMARK(izip_tree_t);
+MEMORY_BENCHMARK(isplay_tree_t);
+MEMORY_BENCHMARK(std_multiset);
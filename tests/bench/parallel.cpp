@@ -0,0 +1,61 @@
+// SPDX-FileCopyrightText: 2025 TypeCombinator <typecombinator@foxmail.com>
+//
+// SPDX-License-Identifier: BSD 3-Clause
+
+#include <benchmark/benchmark.h>
+#include <vector>
+#include <random>
+#include <common/apple.hpp>
+#include <common/workload.hpp>
+#include <common/perf_counters.hpp>
+#include <uit/irwbt.hpp>
+#include <uit/parallel.hpp>
+
+using irwbt_apple_t = uit::irwbt<&rsbt_apple::right, &rsbt_apple::left, &rsbt_apple::size>;
+
+// The statistics scan of a whole index, the nodes are linked in random order.
+static void serial_scan(benchmark::State& state) {
+    std::size_t size = state.range(0);
+    auto&& data = generate_apples<rsbt_apple>(23, size);
+    irwbt_apple_t tree{};
+
+    for (auto& e: data) {
+        tree.insert_multi(&e);
+    }
+    perf_scope perf(state);
+    for (auto _: state) {
+        uint64_t sum = 0;
+        tree.for_each([&sum](rsbt_apple& node) { sum += node.weight; });
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * size);
+}
+
+BENCHMARK(serial_scan)->Arg(1 << 16)->Arg(1 << 22)->UseRealTime();
+
+// The second argument is the number of threads.
+static void parallel_scan(benchmark::State& state) {
+    std::size_t size = state.range(0);
+    std::size_t threads = state.range(1);
+    auto&& data = generate_apples<rsbt_apple>(23, size);
+    irwbt_apple_t tree{};
+
+    for (auto& e: data) {
+        tree.insert_multi(&e);
+    }
+    perf_scope perf(state);
+    for (auto _: state) {
+        uint64_t sum = uit::parallel_reduce(
+            tree,
+            uint64_t{0},
+            [](uint64_t a, uint64_t b) { return a + b; },
+            [](const rsbt_apple& node) { return node.weight; },
+            threads);
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * size);
+}
+
+BENCHMARK(parallel_scan)
+    ->ArgsProduct({{1 << 16, 1 << 22}, {1, 2, 4, 8}})
+    ->UseRealTime();
@@ -0,0 +1,119 @@
+// SPDX-FileCopyrightText: 2025 TypeCombinator <typecombinator@foxmail.com>
+//
+// SPDX-License-Identifier: BSD 3-Clause
+
+#include <benchmark/benchmark.h>
+#include <vector>
+#include <random>
+#include <common/apple.hpp>
+#include <common/workload.hpp>
+#include <common/perf_counters.hpp>
+#include <uit/irwbt.hpp>
+#include <uit/snapshot.hpp>
+
+using irwbt_apple_t = uit::irwbt<&rsbt_apple::right, &rsbt_apple::left, &rsbt_apple::size>;
+
+static void irwbt_find_random(benchmark::State& state) {
+    std::size_t size = state.range(0);
+    auto&& data = generate_apples<rsbt_apple>(23, size);
+    auto&& queries = generate_keys(29, size, keys::uniform);
+    irwbt_apple_t tree{};
+
+    for (auto& e: data) {
+        tree.insert_multi(&e);
+    }
+    perf_scope perf(state);
+    for (auto _: state) {
+        for (auto q: queries) {
+            benchmark::DoNotOptimize(tree.find(q));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * queries.size());
+    state.SetComplexityN(state.range(0));
+}
+
+BENCHMARK(irwbt_find_random)->RangeMultiplier(4)->Range(1 << 10, 1 << 22)->Complexity();
+
+static void irwbt_lower_bound_random(benchmark::State& state) {
+    std::size_t size = state.range(0);
+    auto&& data = generate_apples<rsbt_apple>(23, size);
+    auto&& queries = generate_keys(29, size, keys::uniform);
+    irwbt_apple_t tree{};
+
+    for (auto& e: data) {
+        tree.insert_multi(&e);
+    }
+    perf_scope perf(state);
+    for (auto _: state) {
+        for (auto q: queries) {
+            benchmark::DoNotOptimize(tree.lower_bound(q));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * queries.size());
+    state.SetComplexityN(state.range(0));
+}
+
+BENCHMARK(irwbt_lower_bound_random)->RangeMultiplier(4)->Range(1 << 10, 1 << 22)->Complexity();
+
+static void snapshot_find_random(benchmark::State& state) {
+    std::size_t size = state.range(0);
+    auto&& data = generate_apples<rsbt_apple>(23, size);
+    auto&& queries = generate_keys(29, size, keys::uniform);
+    irwbt_apple_t tree{};
+
+    for (auto& e: data) {
+        tree.insert_multi(&e);
+    }
+    auto snapshot = uit::snapshot<&rsbt_apple::weight>(tree);
+    perf_scope perf(state);
+    for (auto _: state) {
+        for (auto q: queries) {
+            benchmark::DoNotOptimize(snapshot.find(q));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * queries.size());
+    state.SetComplexityN(state.range(0));
+}
+
+BENCHMARK(snapshot_find_random)->RangeMultiplier(4)->Range(1 << 10, 1 << 22)->Complexity();
+
+static void snapshot_lower_bound_random(benchmark::State& state) {
+    std::size_t size = state.range(0);
+    auto&& data = generate_apples<rsbt_apple>(23, size);
+    auto&& queries = generate_keys(29, size, keys::uniform);
+    irwbt_apple_t tree{};
+
+    for (auto& e: data) {
+        tree.insert_multi(&e);
+    }
+    auto snapshot = uit::snapshot<&rsbt_apple::weight>(tree);
+    perf_scope perf(state);
+    for (auto _: state) {
+        for (auto q: queries) {
+            benchmark::DoNotOptimize(snapshot.lower_bound(q));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * queries.size());
+    state.SetComplexityN(state.range(0));
+}
+
+BENCHMARK(snapshot_lower_bound_random)->RangeMultiplier(4)->Range(1 << 10, 1 << 22)->Complexity();
+
+static void snapshot_rebuild(benchmark::State& state) {
+    std::size_t size = state.range(0);
+    auto&& data = generate_apples<rsbt_apple>(23, size);
+    irwbt_apple_t tree{};
+    uit::eytzinger_snapshot<&rsbt_apple::weight> snapshot{};
+
+    for (auto& e: data) {
+        tree.insert_multi(&e);
+    }
+    perf_scope perf(state);
+    for (auto _: state) {
+        snapshot.rebuild(tree);
+        benchmark::DoNotOptimize(snapshot.size());
+    }
+    state.SetComplexityN(state.range(0));
+}
+
+BENCHMARK(snapshot_rebuild)->RangeMultiplier(4)->Range(1 << 10, 1 << 22)->Complexity();
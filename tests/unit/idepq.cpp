@@ -0,0 +1,109 @@
+// SPDX-FileCopyrightText: 2025 TypeCombinator <typecombinator@foxmail.com>
+//
+// SPDX-License-Identifier: BSD 3-Clause
+
+#include <uit/idepq.hpp>
+#include <vector>
+#include <random>
+#include <set>
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <common/apple.hpp>
+
+using idepq_apple_t = uit::idepq<&rsbt_apple::right, &rsbt_apple::left, &rsbt_apple::size>;
+
+TEST(idepq_test, empty) {
+    idepq_apple_t q{};
+    EXPECT_TRUE(q.empty());
+    EXPECT_EQ(q.size(), 0);
+    EXPECT_EQ(idepq_apple_t::bounded(8).capacity(), 8);
+}
+
+TEST(idepq_test, both_ends) {
+    idepq_apple_t q{};
+    std::multiset<uint64_t> weights;
+    std::vector<rsbt_apple> vec;
+    const std::size_t vec_size = 2000;
+    std::mt19937 gen(23);
+    std::uniform_int_distribution<uint64_t> dis(0, vec_size / 4);
+    std::uniform_int_distribution<int> op_dis(0, 3);
+
+    vec.reserve(vec_size);
+    for (std::size_t i = 0; i < vec_size; i++) {
+        vec.emplace_back(dis(gen), i);
+    }
+    for (std::size_t i = 0; i < vec_size;) {
+        int op = op_dis(gen);
+        if ((op < 2) || q.empty()) {
+            EXPECT_EQ(q.push(&vec[i]), nullptr);
+            weights.insert(vec[i++].weight);
+        } else if (op < 3) {
+            EXPECT_EQ(q.pop_min()->weight, *weights.begin());
+            weights.erase(weights.begin());
+        } else {
+            EXPECT_EQ(q.pop_max()->weight, *weights.rbegin());
+            weights.erase(std::prev(weights.end()));
+        }
+        ASSERT_EQ(q.size(), weights.size());
+        if (!q.empty()) {
+            ASSERT_EQ(q.top_min().weight, *weights.begin());
+            ASSERT_EQ(q.top_max().weight, *weights.rbegin());
+        }
+    }
+}
+
+TEST(idepq_test, bounded) {
+    const std::size_t capacity = 100;
+    auto q = idepq_apple_t::bounded(capacity);
+    std::vector<rsbt_apple> vec;
+    std::vector<uint64_t> weights;
+    const std::size_t vec_size = 5000;
+    std::mt19937 gen(23);
+    std::uniform_int_distribution<uint64_t> dis(0, vec_size);
+
+    vec.reserve(vec_size);
+    for (std::size_t i = 0; i < vec_size; i++) {
+        vec.emplace_back(dis(gen), i);
+        weights.push_back(vec.back().weight);
+    }
+    std::size_t evicted = 0;
+    for (auto &i: vec) {
+        rsbt_apple *worst = (q.size() < capacity) ? nullptr : &q.top_max();
+        rsbt_apple *node = q.push(&i);
+        if (worst == nullptr) {
+            EXPECT_EQ(node, nullptr);
+        } else if (i.weight < worst->weight) {
+            EXPECT_EQ(node, worst);
+            evicted++;
+        } else {
+            EXPECT_EQ(node, &i);
+        }
+        ASSERT_LE(q.size(), capacity);
+    }
+    EXPECT_GT(evicted, 0);
+    // The smallest ones are kept.
+    std::sort(weights.begin(), weights.end());
+    for (std::size_t i = 0; i < capacity; i++) {
+        EXPECT_EQ(q.pop_min()->weight, weights[i]);
+    }
+    EXPECT_TRUE(q.empty());
+}
+
+TEST(idepq_test, erase) {
+    auto q = idepq_apple_t::bounded(2);
+    rsbt_apple a0{500, 0};
+    rsbt_apple a1{500, 1};
+    rsbt_apple a2{400, 2};
+
+    EXPECT_EQ(q.push(&a0), nullptr);
+    EXPECT_EQ(q.push(&a1), nullptr);
+    EXPECT_TRUE(q.erase(&a1));
+    EXPECT_FALSE(q.erase(&a1));
+    EXPECT_EQ(q.push(&a2), nullptr);
+    EXPECT_EQ(&q.top_min(), &a2);
+    EXPECT_EQ(&q.top_max(), &a0);
+    std::size_t count = 0;
+    q.clear_and_dispose([&count](rsbt_apple *) { count++; });
+    EXPECT_EQ(count, 2);
+    EXPECT_TRUE(q.empty());
+}
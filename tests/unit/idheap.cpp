@@ -0,0 +1,316 @@
+// SPDX-FileCopyrightText: 2025 TypeCombinator <typecombinator@foxmail.com>
+//
+// SPDX-License-Identifier: BSD 3-Clause
+
+#include <uit/idheap.hpp>
+#include <uit/iiqheap.hpp>
+#include <vector>
+#include <random>
+#include <set>
+#include <utility>
+#include <gtest/gtest.h>
+#include <common/apple.hpp>
+
+using iiqheap_apple_t = uit::iiqheap<&iq_apple::index>;
+// The segments of 4 pointers make the children of most nodes cross the boundaries of the indices.
+using iiqheap_small_segment_apple_t =
+    uit::iiqheap<&iq_apple::index, std::less<>, uit::segmented<std::allocator<iq_apple *>, 2>>;
+using iiqheap_segmented_apple_t =
+    uit::iiqheap<&iq_apple::index, std::less<>, uit::segmented<std::allocator<iq_apple *>>>;
+using iiqheap_key_apple_t = uit::iiqheap<
+    &iq_apple::index,
+    std::less<>,
+    uit::key_inline<std::allocator<iq_apple *>, &iq_apple::weight>>;
+using idheap_binary_apple_t = uit::idheap<&iq_apple::index, 2>;
+using idheap_octal_segmented_apple_t =
+    uit::idheap<&iq_apple::index, 8, std::less<>, uit::segmented<std::allocator<iq_apple *>, 3>>;
+using idheap_hex_key_apple_t = uit::idheap<
+    &iq_apple::index,
+    16,
+    std::less<>,
+    uit::key_inline<std::allocator<iq_apple *>, &iq_apple::weight>>;
+
+template <typename Heap>
+class idheap_test : public testing::Test {
+   protected:
+    void SetUp() override {
+        std::mt19937 gen(23);
+        std::uniform_int_distribution<uint64_t> dis(0, vec_size / 4);
+
+        vec.reserve(vec_size);
+        for (std::size_t i = 0; i < vec_size; i++) {
+            vec.emplace_back(dis(gen), i);
+        }
+    }
+
+    // The size and the top must agree with the weights.
+    void check(const Heap &heap, const std::multiset<uint64_t> &weights) {
+        ASSERT_EQ(heap.size(), weights.size());
+        if (!heap.empty()) {
+            ASSERT_EQ(heap.top().weight, *weights.begin());
+        }
+    }
+
+    static constexpr std::size_t vec_size = 3000;
+    std::vector<iq_apple> vec;
+};
+
+using heap_types = testing::Types<
+    iiqheap_apple_t,
+    iiqheap_small_segment_apple_t,
+    iiqheap_segmented_apple_t,
+    iiqheap_key_apple_t,
+    idheap_binary_apple_t,
+    idheap_octal_segmented_apple_t,
+    idheap_hex_key_apple_t>;
+TYPED_TEST_SUITE(idheap_test, heap_types);
+
+TYPED_TEST(idheap_test, push_pop) {
+    TypeParam heap(4);
+    std::multiset<uint64_t> weights;
+    EXPECT_TRUE(heap.empty());
+    EXPECT_GE(heap.capacity(), 4u);
+
+    for (auto &e: this->vec) {
+        heap.push(&e);
+        weights.insert(e.weight);
+        this->check(heap, weights);
+    }
+    EXPECT_GE(heap.capacity(), this->vec_size);
+    while (!heap.empty()) {
+        EXPECT_EQ(heap.top().weight, *weights.begin());
+        weights.erase(weights.begin());
+        heap.pop();
+        this->check(heap, weights);
+    }
+}
+
+TYPED_TEST(idheap_test, remove_and_sift) {
+    TypeParam heap(16);
+    std::multiset<uint64_t> weights;
+    std::set<std::size_t> linked;
+    std::mt19937 gen(29);
+    std::uniform_int_distribution<int> op_dis(0, 3);
+    std::uniform_int_distribution<std::size_t> node_dis(0, this->vec_size - 1);
+    std::uniform_int_distribution<uint64_t> weight_dis(0, this->vec_size);
+
+    for (int i = 0; i < 20000; i++) {
+        std::size_t k = node_dis(gen);
+        iq_apple &e = this->vec[k];
+        int op = op_dis(gen);
+        if (!linked.contains(k)) {
+            heap.push(&e);
+            weights.insert(e.weight);
+            linked.insert(k);
+        } else if (op < 2) {
+            heap.remove(&e);
+            weights.erase(weights.find(e.weight));
+            linked.erase(k);
+        } else {
+            weights.erase(weights.find(e.weight));
+            e.weight = weight_dis(gen);
+            weights.insert(e.weight);
+            heap.sift(&e);
+        }
+        this->check(heap, weights);
+    }
+}
+
+TYPED_TEST(idheap_test, move) {
+    TypeParam heap(8);
+    for (auto &e: this->vec) {
+        heap.push(&e);
+    }
+    TypeParam other(std::move(heap));
+    EXPECT_EQ(other.size(), this->vec_size);
+
+    TypeParam third(8);
+    third.push(&this->vec[0]);
+    third = std::move(other);
+    ASSERT_EQ(third.size(), this->vec_size);
+    uint64_t last = 0;
+    while (!third.empty()) {
+        EXPECT_LE(last, third.top().weight);
+        last = third.top().weight;
+        third.pop();
+    }
+}
+
+TYPED_TEST(idheap_test, clear_and_dispose) {
+    TypeParam heap(8);
+    for (auto &e: this->vec) {
+        heap.push(&e);
+    }
+    auto capacity = heap.capacity();
+    std::size_t count = 0;
+    heap.clear_and_dispose([&count](iq_apple *) { count++; });
+    EXPECT_EQ(count, this->vec_size);
+    EXPECT_TRUE(heap.empty());
+    EXPECT_EQ(heap.capacity(), capacity);
+}
+
+TYPED_TEST(idheap_test, assign_and_push_bulk) {
+    TypeParam heap(4);
+    std::multiset<uint64_t> weights;
+    std::vector<iq_apple *> batch;
+    for (std::size_t i = 0; i < this->vec_size / 2; i++) {
+        batch.push_back(&this->vec[i]);
+        weights.insert(this->vec[i].weight);
+    }
+    heap.assign(batch);
+    this->check(heap, weights);
+
+    // A small batch is pushed one by one, a large one is heapified with the heap.
+    std::size_t next = this->vec_size / 2;
+    for (std::size_t count: {std::size_t{3}, this->vec_size / 2 - 3}) {
+        batch.clear();
+        for (std::size_t i = 0; i < count; i++) {
+            batch.push_back(&this->vec[next]);
+            weights.insert(this->vec[next].weight);
+            next++;
+        }
+        heap.push_bulk(batch);
+        this->check(heap, weights);
+    }
+
+    // The indices must be right after the heapify.
+    for (std::size_t i = 0; i < this->vec_size; i += 3) {
+        heap.remove(&this->vec[i]);
+        weights.erase(weights.find(this->vec[i].weight));
+        this->check(heap, weights);
+    }
+    while (!heap.empty()) {
+        EXPECT_EQ(heap.top().weight, *weights.begin());
+        weights.erase(weights.begin());
+        heap.pop();
+    }
+
+    heap.assign({});
+    EXPECT_TRUE(heap.empty());
+}
+
+TYPED_TEST(idheap_test, replace_top_and_push_pop) {
+    TypeParam heap(8);
+    std::multiset<uint64_t> weights;
+    std::size_t half = this->vec_size / 2;
+    for (std::size_t i = 0; i < half; i++) {
+        heap.push(&this->vec[i]);
+        weights.insert(this->vec[i].weight);
+    }
+    std::mt19937 gen(31);
+    std::uniform_int_distribution<uint64_t> weight_dis(0, this->vec_size / 2);
+
+    // The top is rescheduled like a periodic timer.
+    for (int i = 0; i < 1000; i++) {
+        iq_apple &top = heap.top();
+        weights.erase(weights.begin());
+        top.weight += weight_dis(gen);
+        weights.insert(top.weight);
+        heap.replace_top(&top);
+        this->check(heap, weights);
+    }
+
+    // The node out of the heap is pushed, and the top is popped unless the node would be the top.
+    iq_apple *out = &this->vec[half];
+    for (int i = 0; i < 1000; i++) {
+        out->weight = weight_dis(gen);
+        weights.insert(out->weight);
+        iq_apple *popped = heap.push_pop(out);
+        EXPECT_EQ(popped->weight, *weights.begin());
+        weights.erase(weights.begin());
+        this->check(heap, weights);
+        out = popped;
+    }
+
+    // The indices must be right after the sifts.
+    for (std::size_t i = 0; i <= half; i++) {
+        if (&this->vec[i] != out) {
+            heap.remove(&this->vec[i]);
+            weights.erase(weights.find(this->vec[i].weight));
+            this->check(heap, weights);
+        }
+    }
+    EXPECT_TRUE(heap.empty());
+    EXPECT_EQ(heap.push_pop(out), out);
+}
+
+TEST(idheap_test, key_inline_slot_bytes) {
+    // The line of the arity 4 fills a cache line, the others are packed without padding.
+    EXPECT_EQ(iiqheap_key_apple_t::slot_bytes, 16u);
+    using binary_t = uit::idheap<
+        &iq_apple::index,
+        2,
+        std::less<>,
+        uit::key_inline<std::allocator<iq_apple *>, &iq_apple::weight>>;
+    EXPECT_EQ(binary_t::slot_bytes, 16u);
+    binary_t binary(100);
+    EXPECT_EQ(binary.capacity(), 101u);
+
+    struct wide_key {
+        uint64_t a;
+        uint64_t b;
+
+        bool operator<(const wide_key &other) const noexcept {
+            return (a < other.a) || ((a == other.a) && (b < other.b));
+        }
+    };
+    using wide_t = uit::idheap<
+        &iq_apple::index,
+        4,
+        std::less<>,
+        uit::key_inline<
+            std::allocator<iq_apple *>,
+            [](const iq_apple &e) { return wide_key{e.weight, 0}; }>>;
+    EXPECT_EQ(wide_t::slot_bytes, 24u);
+    std::vector<iq_apple> vec;
+    for (int i = 0; i < 100; i++) {
+        vec.emplace_back(100 - i, i);
+    }
+    wide_t heap(1);
+    for (auto &e: vec) {
+        heap.push(&e);
+    }
+    EXPECT_EQ(heap.top().sn, 99);
+}
+
+TEST(idheap_test, segmented_capacity) {
+    iiqheap_segmented_apple_t heap(1);
+    // The first segment loses 3 slots, see the notices of the segmented storage.
+    EXPECT_EQ(heap.capacity(), 4096u - 3);
+    std::vector<iq_apple> vec;
+    for (int i = 0; i < 5000; i++) {
+        vec.emplace_back(5000 - i, i);
+    }
+    for (auto &e: vec) {
+        heap.push(&e);
+    }
+    EXPECT_EQ(heap.capacity(), 2 * 4096u - 3);
+    EXPECT_EQ(heap.top().sn, 4999);
+}
+
+TEST(idheap_test, key_inline) {
+    // The key is projected by a lambda, and the greater key is the top.
+    using heap_t = uit::iiqheap<
+        &iq_apple::index,
+        std::greater<>,
+        uit::key_inline<std::allocator<iq_apple *>, [](const iq_apple &e) { return e.weight; }>>;
+    heap_t heap(0);
+    EXPECT_GE(heap.capacity(), 1u);
+    std::vector<iq_apple> vec;
+    for (int i = 0; i < 100; i++) {
+        vec.emplace_back(i, i);
+    }
+    for (auto &e: vec) {
+        heap.push(&e);
+    }
+    EXPECT_EQ(heap.top_key(), 99u);
+
+    // The top is the node of the index 0, its key in the slot is reloaded by sift_up.
+    vec[99].weight = 200;
+    heap.sift_up(&vec[99]);
+    EXPECT_EQ(heap.top_key(), 200u);
+    vec[99].weight = 0;
+    heap.sift_down(&vec[99]);
+    EXPECT_EQ(heap.top().sn, 98);
+    EXPECT_EQ(heap.top_key(), 98u);
+}
@@ -0,0 +1,231 @@
+// SPDX-FileCopyrightText: 2025 TypeCombinator <typecombinator@foxmail.com>
+//
+// SPDX-License-Identifier: BSD 3-Clause
+
+#include <uit/irbt.hpp>
+#include <vector>
+#include <random>
+#include <cmath>
+#include <gtest/gtest.h>
+#include <common/apple.hpp>
+
+using irbt_apple_t =
+    uit::irbt<&rbt_apple::right, &rbt_apple::left, &rbt_apple::parent, &rbt_apple::color>;
+
+// Returns the black height, or -1 if any property of the red-black tree is violated.
+static int validate_subtree(const rbt_apple *root, const rbt_apple *parent) {
+    if (irbt_apple_t::is_sentinel(root)) {
+        return 1;
+    }
+    if (root->parent != parent) {
+        return -1;
+    }
+    if (root->color == irbt_apple_t::red) {
+        if ((root->left->color == irbt_apple_t::red) || (root->right->color == irbt_apple_t::red)) {
+            return -1;
+        }
+    }
+    if (!irbt_apple_t::is_sentinel(root->left) && (root->weight < root->left->weight)) {
+        return -1;
+    }
+    if (!irbt_apple_t::is_sentinel(root->right) && (root->right->weight < root->weight)) {
+        return -1;
+    }
+    int left_height = validate_subtree(root->left, root);
+    int right_height = validate_subtree(root->right, root);
+    if ((left_height < 0) || (left_height != right_height)) {
+        return -1;
+    }
+    return left_height + (root->color == irbt_apple_t::black ? 1 : 0);
+}
+
+// Validate the whole tree from any node in it.
+static bool validate(const rbt_apple *node) {
+    const rbt_apple *root = node;
+    while (!irbt_apple_t::is_sentinel(root->parent)) {
+        root = root->parent;
+    }
+    return (root->color == irbt_apple_t::black) && (validate_subtree(root, root->parent) > 0);
+}
+
+TEST(irbt_test, empty) {
+    irbt_apple_t tree{};
+    EXPECT_TRUE(tree.empty());
+    EXPECT_EQ(tree.size(), 0);
+    EXPECT_TRUE(irbt_apple_t::validate_sentinel());
+}
+
+TEST(irbt_test, insert_multi) {
+    irbt_apple_t tree{};
+    std::vector<rbt_apple> vec;
+    const std::size_t vec_size = 1000;
+    std::size_t max_height = std::ceil(2 * std::log2(vec_size + 1));
+
+    vec.reserve(vec_size);
+    for (std::size_t i = 0; i < vec_size; i++) {
+        vec.emplace_back(i, i);
+    }
+    for (auto &i: vec) {
+        tree.insert_multi(&i);
+    }
+    EXPECT_EQ(tree.size(), vec_size);
+    EXPECT_LE(tree.height(), max_height);
+    EXPECT_TRUE(validate(&vec[0]));
+    EXPECT_TRUE(irbt_apple_t::validate_sentinel());
+}
+
+TEST(irbt_test, insert_unique) {
+    irbt_apple_t tree{};
+    rbt_apple a0{500, 0};
+    rbt_apple a1{501, 1};
+    rbt_apple a2{502, 2};
+    rbt_apple a3{501, 3};
+
+    EXPECT_TRUE(tree.insert(&a0));
+    EXPECT_TRUE(tree.insert(&a1));
+    EXPECT_TRUE(tree.insert(&a2));
+    EXPECT_FALSE(tree.insert(&a3));
+    EXPECT_EQ(tree.size(), 3);
+    EXPECT_EQ(tree.find(501), &a1);
+    EXPECT_EQ(tree.find(503), nullptr);
+}
+
+TEST(irbt_test, remove_leftmost) {
+    irbt_apple_t tree{};
+    std::vector<rbt_apple> vec;
+    const std::size_t vec_size = 1000;
+    std::mt19937 gen(23);
+    std::uniform_int_distribution<uint64_t> dis(0, vec_size / 4);
+
+    vec.reserve(vec_size);
+    for (std::size_t i = 0; i < vec_size; i++) {
+        vec.emplace_back(dis(gen), i);
+    }
+    for (auto &i: vec) {
+        tree.insert_multi(&i);
+    }
+    uint64_t last = 0;
+    std::size_t count = 0;
+    while (!tree.empty()) {
+        const rbt_apple *node = tree.remove_leftmost();
+        EXPECT_LE(last, node->weight);
+        last = node->weight;
+        count++;
+    }
+    EXPECT_EQ(count, vec_size);
+    EXPECT_EQ(tree.size(), 0);
+    EXPECT_TRUE(irbt_apple_t::validate_sentinel());
+}
+
+TEST(irbt_test, remove) {
+    irbt_apple_t tree{};
+    std::vector<rbt_apple> vec;
+    const std::size_t vec_size = 1000;
+
+    vec.reserve(vec_size);
+    for (std::size_t i = 0; i < vec_size; i++) {
+        // 7 and 1000 are coprime, so the weights are a permutation.
+        vec.emplace_back(i * 7 % vec_size, i);
+    }
+    for (auto &i: vec) {
+        tree.insert_multi(&i);
+    }
+    for (uint64_t i = 0; i < vec_size; i += 2) {
+        const rbt_apple *node = tree.remove(i);
+        ASSERT_NE(node, nullptr);
+        EXPECT_EQ(node->weight, i);
+        EXPECT_EQ(tree.remove(i), nullptr);
+        ASSERT_TRUE(validate(tree.find(1)));
+    }
+    EXPECT_EQ(tree.size(), vec_size / 2);
+    for (uint64_t i = 1; i < vec_size; i += 2) {
+        EXPECT_EQ(tree.find(i)->weight, i);
+    }
+    EXPECT_TRUE(irbt_apple_t::validate_sentinel());
+}
+
+TEST(irbt_test, erase) {
+    irbt_apple_t tree{};
+    std::vector<rbt_apple> vec;
+    const std::size_t vec_size = 1000;
+    std::mt19937 gen(23);
+    std::uniform_int_distribution<uint64_t> dis(0, 16);
+
+    vec.reserve(vec_size);
+    for (std::size_t i = 0; i < vec_size; i++) {
+        vec.emplace_back(dis(gen), i);
+    }
+    for (auto &i: vec) {
+        tree.insert_multi(&i);
+    }
+    // Erase the exact nodes among many duplicates.
+    for (std::size_t i = 0; i < vec_size; i += 2) {
+        tree.erase(&vec[i]);
+        ASSERT_TRUE(validate(&vec[i + 1]));
+    }
+    EXPECT_EQ(tree.size(), vec_size / 2);
+    for (std::size_t i = 1; i < vec_size; i += 2) {
+        tree.erase(&vec[i]);
+    }
+    EXPECT_TRUE(tree.empty());
+    EXPECT_TRUE(irbt_apple_t::validate_sentinel());
+}
+
+TEST(irbt_test, checked_erase) {
+    irbt_apple_t tree{};
+    std::vector<rbt_apple> vec;
+    const std::size_t vec_size = 1000;
+    std::mt19937 gen(23);
+    std::uniform_int_distribution<uint64_t> dis(0, 16);
+
+    vec.reserve(vec_size);
+    for (std::size_t i = 0; i < vec_size; i++) {
+        vec.emplace_back(dis(gen), i);
+    }
+    for (auto &i: vec) {
+        tree.insert_multi(&i);
+    }
+    // A node that was erased is rejected.
+    for (std::size_t i = 0; i < vec_size; i += 2) {
+        ASSERT_TRUE(tree.checked_erase(&vec[i]));
+        ASSERT_TRUE(validate(&vec[i + 1]));
+        ASSERT_FALSE(tree.checked_erase(&vec[i]));
+    }
+    EXPECT_EQ(tree.size(), vec_size / 2);
+    // A node of another tree is rejected, even if its key is in this tree.
+    irbt_apple_t other{};
+    rbt_apple foreign{vec[1].weight, -1};
+    other.insert_multi(&foreign);
+    EXPECT_FALSE(tree.checked_erase(&foreign));
+    EXPECT_EQ(tree.size(), vec_size / 2);
+    EXPECT_TRUE(other.checked_erase(&foreign));
+    for (std::size_t i = 1; i < vec_size; i += 2) {
+        ASSERT_TRUE(tree.checked_erase(&vec[i]));
+    }
+    EXPECT_TRUE(tree.empty());
+    EXPECT_FALSE(tree.checked_erase(&vec[1]));
+    EXPECT_TRUE(irbt_apple_t::validate_sentinel());
+}
+
+TEST(irbt_test, clear_and_dispose) {
+    irbt_apple_t tree{};
+    const std::size_t vec_size = 1000;
+    std::mt19937 gen(23);
+    std::uniform_int_distribution<uint64_t> dis(0, vec_size / 4);
+
+    for (std::size_t i = 0; i < vec_size; i++) {
+        tree.insert_multi(new rbt_apple{dis(gen), static_cast<int>(i)});
+    }
+    // The nodes are freed by the disposer, and they're disposed in order.
+    uint64_t last = 0;
+    std::size_t count = 0;
+    tree.clear_and_dispose([&last, &count](rbt_apple *node) {
+        EXPECT_LE(last, node->weight);
+        last = node->weight;
+        count++;
+        delete node;
+    });
+    EXPECT_EQ(count, vec_size);
+    EXPECT_TRUE(tree.empty());
+    EXPECT_EQ(tree.size(), 0);
+}
@@ -0,0 +1,151 @@
+// SPDX-FileCopyrightText: 2025 TypeCombinator <typecombinator@foxmail.com>
+//
+// SPDX-License-Identifier: BSD 3-Clause
+
+#include <uit/irheap.hpp>
+#include <vector>
+#include <random>
+#include <set>
+#include <gtest/gtest.h>
+#include <common/apple.hpp>
+
+using irheap_apple_t = uit::irheap<&rsbt_apple::right, &rsbt_apple::left>;
+
+// Returns the size of the subtree, or -1 if a child is less than its parent.
+static long validate(const rsbt_apple *root) {
+    if (root == nullptr) {
+        return 0;
+    }
+    long size = 1;
+    for (const rsbt_apple *child: {root->left, root->right}) {
+        if (child == nullptr) {
+            continue;
+        }
+        long child_size = validate(child);
+        if ((child_size < 0) || (child->weight < root->weight)) {
+            return -1;
+        }
+        size += child_size;
+    }
+    return size;
+}
+
+class irheap_test : public testing::Test {
+   protected:
+    void SetUp() override {
+        std::mt19937 gen(37);
+        std::uniform_int_distribution<uint64_t> dis(0, vec_size / 4);
+
+        vec.reserve(vec_size);
+        for (std::size_t i = 0; i < vec_size; i++) {
+            vec.emplace_back(dis(gen), i);
+        }
+    }
+
+    // The heap is drained in the order of the weights.
+    static void drain(irheap_apple_t &heap, std::multiset<uint64_t> &weights) {
+        ASSERT_EQ(validate(&heap.top()), static_cast<long>(weights.size()));
+        while (!heap.empty()) {
+            ASSERT_EQ(heap.top().weight, *weights.begin());
+            weights.erase(weights.begin());
+            heap.pop();
+        }
+        EXPECT_TRUE(weights.empty());
+    }
+
+    static constexpr std::size_t vec_size = 1000;
+    std::vector<rsbt_apple> vec;
+};
+
+TEST_F(irheap_test, push_pop) {
+    irheap_apple_t heap;
+    std::multiset<uint64_t> weights;
+    EXPECT_TRUE(heap.empty());
+    for (auto &e: vec) {
+        heap.push(&e);
+        weights.insert(e.weight);
+        ASSERT_EQ(heap.top().weight, *weights.begin());
+    }
+    EXPECT_EQ(heap.size(), vec_size);
+    drain(heap, weights);
+}
+
+TEST_F(irheap_test, assign) {
+    for (std::size_t size: {std::size_t{1}, std::size_t{2}, std::size_t{7}, vec_size}) {
+        irheap_apple_t heap;
+        std::multiset<uint64_t> weights;
+        std::vector<rsbt_apple *> batch;
+        for (std::size_t i = 0; i < size; i++) {
+            batch.push_back(&vec[i]);
+            weights.insert(vec[i].weight);
+        }
+        heap.assign(batch);
+        EXPECT_EQ(heap.size(), size);
+        drain(heap, weights);
+    }
+
+    irheap_apple_t heap;
+    heap.assign({});
+    EXPECT_TRUE(heap.empty());
+}
+
+TEST_F(irheap_test, push_bulk) {
+    irheap_apple_t heap;
+    std::multiset<uint64_t> weights;
+    std::vector<rsbt_apple *> batch;
+    for (std::size_t i = 0; i < vec_size; i++) {
+        batch.push_back(&vec[i]);
+        weights.insert(vec[i].weight);
+        // The first batch is heapified, the rest are pushed.
+        if (batch.size() == 100) {
+            heap.push_bulk(batch);
+            batch.clear();
+        }
+    }
+    EXPECT_EQ(heap.size(), vec_size);
+    drain(heap, weights);
+}
+
+TEST_F(irheap_test, replace_top_and_push_pop) {
+    irheap_apple_t heap;
+    std::multiset<uint64_t> weights;
+    for (std::size_t i = 0; i + 1 < vec_size; i++) {
+        heap.push(&vec[i]);
+        weights.insert(vec[i].weight);
+    }
+    std::mt19937 gen(41);
+    std::uniform_int_distribution<uint64_t> weight_dis(0, vec_size / 4);
+
+    for (int i = 0; i < 1000; i++) {
+        rsbt_apple &top = heap.top();
+        weights.erase(weights.begin());
+        top.weight += weight_dis(gen);
+        weights.insert(top.weight);
+        heap.replace_top(&top);
+        ASSERT_EQ(heap.top().weight, *weights.begin());
+    }
+
+    rsbt_apple *out = &vec[vec_size - 1];
+    for (int i = 0; i < 1000; i++) {
+        out->weight = weight_dis(gen);
+        weights.insert(out->weight);
+        rsbt_apple *popped = heap.push_pop(out);
+        ASSERT_EQ(popped->weight, *weights.begin());
+        weights.erase(weights.begin());
+        out = popped;
+    }
+    EXPECT_EQ(heap.size(), vec_size - 1);
+    drain(heap, weights);
+    EXPECT_EQ(heap.push_pop(out), out);
+}
+
+TEST_F(irheap_test, clear_and_dispose) {
+    irheap_apple_t heap;
+    for (auto &e: vec) {
+        heap.push(&e);
+    }
+    std::size_t count = 0;
+    heap.clear_and_dispose([&count](rsbt_apple *) { count++; });
+    EXPECT_EQ(count, vec_size);
+    EXPECT_TRUE(heap.empty());
+}
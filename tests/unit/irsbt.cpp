@@ -4,11 +4,19 @@
 
 #include <uit/irsbt.hpp>
 #include <vector>
+#include <string>
+#include <string_view>
+#include <algorithm>
 #include <cmath>
+#include <random>
 #include <gtest/gtest.h>
 #include <common/apple.hpp>
 
 using irsbt_apple_t = uit::irsbt<&rsbt_apple::right, &rsbt_apple::left, &rsbt_apple::size>;
+using irsbt_tiebreak_apple_t = uit::
+    irsbt<&rsbt_apple::right, &rsbt_apple::left, &rsbt_apple::size, uit::address_tiebreak<>>;
+using irsbt_cached_apple_t =
+    uit::irsbt_cached<&rsbt_apple::right, &rsbt_apple::left, &rsbt_apple::size>;
 
 TEST(isbt_test, empty) {
     irsbt_apple_t tree{};
@@ -237,3 +245,296 @@ TEST(isbt_test, position) {
     EXPECT_EQ(tree.position(503), 3);
     EXPECT_EQ(tree.position(504), std::size_t(-1));
 }
+
+TEST(isbt_test, lower_bound) {
+    irsbt_apple_t tree{};
+    rsbt_apple a0{500, 0};
+    rsbt_apple a1{502, 1};
+    rsbt_apple a2{504, 2};
+
+    tree.insert_unique(&a0);
+    tree.insert_unique(&a1);
+    tree.insert_unique(&a2);
+
+    EXPECT_EQ(tree.lower_bound(a0), &a0);
+    EXPECT_EQ(tree.lower_bound(499), &a0);
+    EXPECT_EQ(tree.lower_bound(501), &a1);
+    EXPECT_EQ(tree.lower_bound(504), &a2);
+    EXPECT_EQ(tree.lower_bound(505), nullptr);
+}
+
+TEST(isbt_test, push_back_max) {
+    irsbt_apple_t tree{};
+    std::vector<rsbt_apple> vec;
+    const std::size_t vec_size = 100;
+    std::size_t max_height = std::ceil(1.44 * std::log2(vec_size + 1.5) - 1.33);
+
+    vec.reserve(vec_size);
+    for (std::size_t i = 0; i < vec_size; i++) {
+        vec.emplace_back(i, i);
+    }
+    for (auto &i: vec) {
+        tree.push_back_max(&i);
+    }
+    EXPECT_EQ(tree.size(), vec_size);
+    EXPECT_LE(tree.height(), max_height);
+    for (std::size_t i = 0; i < vec_size; i++) {
+        EXPECT_EQ(tree.at(i), &vec[i]);
+    }
+}
+
+TEST(isbt_test, insert_hint) {
+    irsbt_apple_t tree{};
+    std::vector<rsbt_apple> vec;
+    const std::size_t vec_size = 100;
+    std::size_t max_height = std::ceil(1.44 * std::log2(vec_size + 1.5) - 1.33);
+
+    vec.reserve(vec_size);
+    for (std::size_t i = 0; i < vec_size; i++) {
+        // Every 10th node goes back a little.
+        vec.emplace_back((i % 10 == 9) ? (i * 4 - 6) : (i * 4), i);
+    }
+    rsbt_apple *hint = nullptr;
+    for (auto &i: vec) {
+        tree.insert_hint(hint, &i);
+        // The hint is the rightmost node.
+        if ((hint == nullptr) || !(i < *hint)) {
+            hint = &i;
+        }
+        ASSERT_EQ(hint, tree.back());
+    }
+    EXPECT_EQ(tree.size(), vec_size);
+    EXPECT_LE(tree.height(), max_height);
+    for (std::size_t i = 1; i < vec_size; i++) {
+        EXPECT_LE(tree.at(i - 1)->weight, tree.at(i)->weight);
+    }
+}
+
+TEST(isbt_test, insert_batch) {
+    irsbt_apple_t tree{};
+    std::vector<rsbt_apple> vec;
+    std::vector<rsbt_apple *> batch;
+    const std::size_t vec_size = 1000;
+    const std::size_t batch_size = 64;
+    std::size_t max_height = std::ceil(1.44 * std::log2(vec_size + 1.5) - 1.33);
+    std::mt19937 gen(23);
+    std::uniform_int_distribution<uint64_t> dis(0, vec_size);
+
+    vec.reserve(vec_size);
+    for (std::size_t i = 0; i < vec_size; i++) {
+        vec.emplace_back(dis(gen), i);
+    }
+    for (std::size_t i = 0; i < vec_size; i += batch_size) {
+        batch.clear();
+        for (std::size_t j = i; (j < i + batch_size) && (j < vec_size); j++) {
+            batch.push_back(&vec[j]);
+        }
+        tree.insert_batch<&rsbt_apple::weight>(batch);
+    }
+    EXPECT_EQ(tree.size(), vec_size);
+    EXPECT_LE(tree.height(), max_height);
+    for (std::size_t i = 1; i < vec_size; i++) {
+        EXPECT_LE(tree.at(i - 1)->weight, tree.at(i)->weight);
+    }
+}
+
+TEST(isbt_test, cached) {
+    irsbt_cached_apple_t tree{};
+    std::vector<rsbt_apple> vec;
+    const std::size_t vec_size = 1000;
+    std::mt19937 gen(23);
+    std::uniform_int_distribution<uint64_t> dis(0, vec_size / 4);
+
+    EXPECT_EQ(tree.front(), nullptr);
+    EXPECT_EQ(tree.back(), nullptr);
+    vec.reserve(vec_size);
+    for (std::size_t i = 0; i < vec_size; i++) {
+        vec.emplace_back(dis(gen), i);
+    }
+    for (auto &i: vec) {
+        tree.insert_multi(&i);
+        EXPECT_EQ(tree.front(), tree.at(0));
+        EXPECT_EQ(tree.back(), tree.at(tree.size() - 1));
+    }
+    // Pop from both ends alternately.
+    for (std::size_t i = 0; i < vec_size; i++) {
+        rsbt_apple *node = (i % 2 == 0) ? tree.front() : tree.back();
+        EXPECT_EQ((i % 2 == 0) ? tree.pop_front() : tree.pop_back(), node);
+        if (!tree.empty()) {
+            EXPECT_EQ(tree.front(), tree.at(0));
+            EXPECT_EQ(tree.back(), tree.at(tree.size() - 1));
+        }
+    }
+    EXPECT_TRUE(tree.empty());
+    EXPECT_EQ(tree.front(), nullptr);
+    EXPECT_EQ(tree.back(), nullptr);
+}
+
+TEST(isbt_test, clear_and_dispose) {
+    irsbt_apple_t tree{};
+    const std::size_t vec_size = 1000;
+    std::mt19937 gen(23);
+    std::uniform_int_distribution<uint64_t> dis(0, vec_size / 4);
+
+    for (std::size_t i = 0; i < vec_size; i++) {
+        tree.insert_multi(new rsbt_apple{dis(gen), static_cast<int>(i)});
+    }
+    // The nodes are freed by the disposer, and they're disposed in order.
+    uint64_t last = 0;
+    std::size_t count = 0;
+    tree.clear_and_dispose([&last, &count](rsbt_apple *node) {
+        EXPECT_LE(last, node->weight);
+        last = node->weight;
+        count++;
+        delete node;
+    });
+    EXPECT_EQ(count, vec_size);
+    EXPECT_TRUE(tree.empty());
+    EXPECT_EQ(tree.size(), 0);
+}
+
+// Many nodes share a few keys, and each one is erased by itself in a random order.
+template <typename Tree>
+static void erase_duplicates() {
+    Tree tree{};
+    std::vector<rsbt_apple> vec;
+    std::vector<rsbt_apple *> order;
+    const std::size_t vec_size = 2000;
+    std::mt19937 gen(23);
+    std::uniform_int_distribution<uint64_t> dis(0, 7);
+
+    vec.reserve(vec_size);
+    for (std::size_t i = 0; i < vec_size; i++) {
+        vec.emplace_back(dis(gen), i);
+    }
+    for (auto &i: vec) {
+        tree.insert_multi(&i);
+        order.push_back(&i);
+    }
+    std::shuffle(order.begin(), order.end(), gen);
+    for (std::size_t i = 0; i < vec_size; i++) {
+        ASSERT_TRUE(tree.erase(order[i]));
+        EXPECT_EQ(tree.size(), vec_size - i - 1);
+        if (i % 100 == 0) {
+            EXPECT_FALSE(tree.erase(order[i]));
+            // The others are still there in order, and the sizes are right.
+            uint64_t last = 0;
+            std::size_t count = 0;
+            tree.for_each([&last, &count](const rsbt_apple &node) {
+                EXPECT_LE(last, node.weight);
+                last = node.weight;
+                count++;
+            });
+            EXPECT_EQ(count, tree.size());
+            for (std::size_t j = 1; j < tree.size(); j++) {
+                EXPECT_LE(tree.at(j - 1)->weight, tree.at(j)->weight);
+            }
+        }
+    }
+    EXPECT_TRUE(tree.empty());
+}
+
+TEST(isbt_test, erase) {
+    irsbt_apple_t tree{};
+    rsbt_apple a0{500, 0};
+    rsbt_apple a1{500, 1};
+    rsbt_apple a2{500, 2};
+    rsbt_apple a3{501, 3};
+
+    tree.insert_multi(&a0);
+    tree.insert_multi(&a1);
+    tree.insert_multi(&a3);
+    EXPECT_FALSE(tree.erase(&a2));
+    EXPECT_TRUE(tree.erase(&a1));
+    EXPECT_FALSE(tree.erase(&a1));
+    EXPECT_EQ(tree.size(), 2);
+    EXPECT_EQ(tree.find(500), &a0);
+    EXPECT_TRUE(tree.erase(&a3));
+    EXPECT_TRUE(tree.erase(&a0));
+    EXPECT_TRUE(tree.empty());
+}
+
+TEST(isbt_test, erase_duplicates) {
+    erase_duplicates<irsbt_apple_t>();
+}
+
+TEST(isbt_test, erase_address_tiebreak) {
+    erase_duplicates<irsbt_tiebreak_apple_t>();
+}
+
+TEST(isbt_test, cached_erase) {
+    irsbt_cached_apple_t tree{};
+    rsbt_apple a0{500, 0};
+    rsbt_apple a1{500, 1};
+    rsbt_apple a2{501, 2};
+    rsbt_apple a3{501, 3};
+
+    tree.insert_multi(&a0);
+    tree.insert_multi(&a1);
+    tree.insert_multi(&a2);
+    tree.insert_multi(&a3);
+    EXPECT_TRUE(tree.erase(&a0));
+    EXPECT_EQ(tree.front(), &a1);
+    EXPECT_TRUE(tree.erase(&a3));
+    EXPECT_EQ(tree.back(), &a2);
+    EXPECT_FALSE(tree.erase(&a3));
+    EXPECT_TRUE(tree.erase(&a1));
+    EXPECT_TRUE(tree.erase(&a2));
+    EXPECT_EQ(tree.front(), nullptr);
+    EXPECT_EQ(tree.back(), nullptr);
+}
+
+static std::size_t compare_count = 0;
+
+struct counting_compare : str_apple_compare {
+    template <typename A, typename B>
+    std::strong_ordering operator()(const A &a, const B &b) const noexcept {
+        compare_count++;
+        return key(a) <=> key(b);
+    }
+};
+
+// A three-way comparator is called once per level by the lookups.
+TEST(isbt_test, three_way_compare) {
+    using tree_t = uit::irsbt<&str_apple::right, &str_apple::left, &str_apple::size, counting_compare>;
+    tree_t tree{};
+    std::vector<str_apple> vec;
+    const std::size_t vec_size = 1000;
+    std::mt19937 gen(23);
+
+    vec.reserve(vec_size);
+    for (std::size_t i = 0; i < vec_size; i++) {
+        vec.emplace_back("key-" + std::to_string(i * 7 % vec_size), i);
+    }
+    std::shuffle(vec.begin(), vec.end(), gen);
+    for (auto &i: vec) {
+        tree.insert_multi(&i);
+    }
+    for (auto &i: vec) {
+        compare_count = 0;
+        EXPECT_EQ(tree.find(std::string_view(i.name)), &i);
+        EXPECT_LE(compare_count, tree.height());
+    }
+    compare_count = 0;
+    EXPECT_EQ(tree.find(std::string_view("key")), nullptr);
+    EXPECT_LE(compare_count, tree.height());
+    str_apple dup{vec[0].name, -1};
+    EXPECT_EQ(tree.insert_unique(&dup), &vec[0]);
+    EXPECT_EQ(tree.size(), vec_size);
+}
+
+// std::less with operator<=> on the nodes.
+TEST(isbt_test, spaceship_operator) {
+    using tree_t = uit::irsbt<&str_apple::right, &str_apple::left, &str_apple::size>;
+    tree_t tree{};
+    str_apple a0{"apple", 0};
+    str_apple a1{"banana", 1};
+    str_apple a2{"cherry", 2};
+    str_apple key{"banana", 3};
+
+    tree.insert_multi(&a2);
+    tree.insert_multi(&a0);
+    tree.insert_multi(&a1);
+    EXPECT_EQ(tree.find(key), &a1);
+    EXPECT_EQ(tree.lower_bound(key), &a1);
+}
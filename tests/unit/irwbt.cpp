@@ -1,3 +1,831 @@
 // SPDX-FileCopyrightText: 2025 TypeCombinator <typecombinator@foxmail.com>
 //
 // SPDX-License-Identifier: BSD 3-Clause
+
+#include <uit/irwbt.hpp>
+#include <vector>
+#include <string>
+#include <string_view>
+#include <random>
+#include <cmath>
+#include <algorithm>
+#include <set>
+#include <gtest/gtest.h>
+#include <common/apple.hpp>
+
+using irwbt_apple_t = uit::irwbt<&rsbt_apple::right, &rsbt_apple::left, &rsbt_apple::size>;
+using irwbt_cached_apple_t =
+    uit::irwbt_cached<&rsbt_apple::right, &rsbt_apple::left, &rsbt_apple::size>;
+using irwbt_tiebreak_apple_t = uit::
+    irwbt<&rsbt_apple::right, &rsbt_apple::left, &rsbt_apple::size, uit::address_tiebreak<>>;
+
+// Returns the size of the subtree, or -1 if the order, the size or the balance is broken.
+template <typename Tree, typename Balance = uit::wbt_balance<>>
+static long validate_subtree(const rsbt_apple *root) {
+    if (Tree::is_sentinel(root)) {
+        return 0;
+    }
+    if (!Tree::is_sentinel(root->left) && (root->weight < root->left->weight)) {
+        return -1;
+    }
+    if (!Tree::is_sentinel(root->right) && (root->right->weight < root->weight)) {
+        return -1;
+    }
+    long left_size = validate_subtree<Tree, Balance>(root->left);
+    long right_size = validate_subtree<Tree, Balance>(root->right);
+    if ((left_size < 0) || (right_size < 0)) {
+        return -1;
+    }
+    if (Balance::is_heavy(left_size, right_size) || Balance::is_heavy(right_size, left_size)) {
+        return -1;
+    }
+    if (static_cast<long>(root->size) != (left_size + right_size + 1)) {
+        return -1;
+    }
+    return left_size + right_size + 1;
+}
+
+// The root is the only node in the tree whose size is equal to the size of the tree, but the removed
+// nodes may have stale sizes, so all candidates are tried.
+template <typename Tree, typename Balance = uit::wbt_balance<>>
+static bool validate(const Tree &tree, const std::vector<rsbt_apple> &vec) {
+    if (tree.empty()) {
+        return true;
+    }
+    for (const auto &i: vec) {
+        if ((i.size == tree.size())
+            && (validate_subtree<Tree, Balance>(&i) == static_cast<long>(tree.size()))) {
+            return true;
+        }
+    }
+    return false;
+}
+
+TEST(irwbt_test, empty) {
+    irwbt_apple_t tree{};
+    EXPECT_TRUE(tree.empty());
+    EXPECT_EQ(tree.size(), 0);
+    EXPECT_TRUE(irwbt_apple_t::validate_sentinel());
+}
+
+TEST(irwbt_test, find) {
+    irwbt_apple_t tree{};
+    rsbt_apple a0{500, 0};
+    rsbt_apple a1{501, 1};
+    rsbt_apple a2{502, 2};
+    rsbt_apple a3{503, 3};
+
+    tree.insert_multi(&a0);
+    tree.insert_multi(&a1);
+    tree.insert_multi(&a2);
+    tree.insert_multi(&a3);
+
+    EXPECT_EQ(tree.find(a0), &a0);
+    EXPECT_EQ(tree.find(503), &a3);
+    EXPECT_EQ(tree.find(504), nullptr);
+}
+
+TEST(irwbt_test, lower_bound) {
+    irwbt_apple_t tree{};
+    std::vector<rsbt_apple> vec;
+    const std::size_t vec_size = 100;
+
+    vec.reserve(vec_size);
+    for (std::size_t i = 0; i < vec_size; i++) {
+        vec.emplace_back(i * 2, i);
+    }
+    for (auto &i: vec) {
+        tree.insert_multi(&i);
+    }
+    for (uint64_t i = 0; i < vec_size * 2 - 1; i++) {
+        EXPECT_EQ(tree.lower_bound(i), &vec[(i + 1) / 2]);
+    }
+    EXPECT_EQ(tree.lower_bound(vec_size * 2 - 1), nullptr);
+}
+
+TEST(irwbt_test, for_each) {
+    irwbt_apple_t tree{};
+    std::vector<rsbt_apple> vec;
+    const std::size_t vec_size = 100;
+
+    vec.reserve(vec_size);
+    for (std::size_t i = 0; i < vec_size; i++) {
+        vec.emplace_back((i * 7) % vec_size, i);
+    }
+    for (auto &i: vec) {
+        tree.insert_multi(&i);
+    }
+    uint64_t expected = 0;
+    tree.for_each([&expected](const rsbt_apple &node) {
+        EXPECT_EQ(node.weight, expected);
+        expected++;
+    });
+    EXPECT_EQ(expected, vec_size);
+}
+
+TEST(irwbt_test, push_back_max) {
+    irwbt_apple_t tree{};
+    std::vector<rsbt_apple> vec;
+    const std::size_t vec_size = 1000;
+
+    vec.reserve(vec_size);
+    for (std::size_t i = 0; i < vec_size; i++) {
+        vec.emplace_back(i / 3, i);
+    }
+    for (auto &i: vec) {
+        tree.push_back_max(&i);
+        ASSERT_TRUE(validate(tree, vec));
+    }
+    EXPECT_EQ(tree.size(), vec_size);
+    EXPECT_LE(tree.height(), 2 * std::log2(vec_size + 1));
+    for (auto &i: vec) {
+        EXPECT_EQ(tree.remove_leftmost(), &i);
+    }
+    EXPECT_TRUE(tree.empty());
+}
+
+TEST(irwbt_test, insert_hint) {
+    irwbt_apple_t tree{};
+    std::vector<rsbt_apple> vec;
+    const std::size_t vec_size = 1000;
+    std::mt19937 gen(23);
+    std::uniform_int_distribution<uint64_t> dis(0, 19);
+
+    vec.reserve(vec_size);
+    for (std::size_t i = 0; i < vec_size; i++) {
+        // Near-monotonic, 5% of the nodes go back a little.
+        uint64_t weight = i * 8;
+        if (dis(gen) == 0) {
+            weight -= std::min<uint64_t>(weight, 20);
+        }
+        vec.emplace_back(weight, i);
+    }
+    rsbt_apple *hint = nullptr;
+    for (auto &i: vec) {
+        tree.insert_hint(hint, &i);
+        // The hint is the rightmost node.
+        if ((hint == nullptr) || !(i < *hint)) {
+            hint = &i;
+        }
+        ASSERT_EQ(hint, tree.back());
+        ASSERT_TRUE(validate(tree, vec));
+    }
+    EXPECT_EQ(tree.size(), vec_size);
+    uint64_t last = 0;
+    tree.for_each([&last](const rsbt_apple &node) {
+        EXPECT_LE(last, node.weight);
+        last = node.weight;
+    });
+}
+
+TEST(irwbt_test, insert_batch) {
+    std::mt19937 gen(23);
+    const std::size_t vec_size = 4000;
+    const std::size_t batch_sizes[] = {1, 3, 16, 100, 700};
+
+    for (auto batch_size: batch_sizes) {
+        irwbt_apple_t tree{};
+        std::vector<rsbt_apple> vec;
+        std::vector<rsbt_apple *> batch;
+        std::uniform_int_distribution<uint64_t> dis(0, vec_size);
+
+        vec.reserve(vec_size);
+        for (std::size_t i = 0; i < vec_size; i++) {
+            vec.emplace_back(dis(gen), i);
+        }
+        for (std::size_t i = 0; i < vec_size; i += batch_size) {
+            batch.clear();
+            for (std::size_t j = i; (j < i + batch_size) && (j < vec_size); j++) {
+                batch.push_back(&vec[j]);
+            }
+            if ((i / batch_size) % 2 == 0) {
+                tree.insert_batch(batch);
+            } else {
+                tree.insert_batch<&rsbt_apple::weight>(batch);
+            }
+            ASSERT_TRUE(validate(tree, vec));
+        }
+        EXPECT_EQ(tree.size(), vec_size);
+        uint64_t last = 0;
+        tree.for_each([&last](const rsbt_apple &node) {
+            EXPECT_LE(last, node.weight);
+            last = node.weight;
+        });
+    }
+}
+
+TEST(irwbt_test, insert_batch_large) {
+    irwbt_apple_t tree{};
+    std::vector<rsbt_apple> vec;
+    std::vector<rsbt_apple *> batch;
+    const std::size_t vec_size = 1000;
+
+    vec.reserve(vec_size);
+    for (std::size_t i = 0; i < vec_size; i++) {
+        vec.emplace_back(vec_size - i, i);
+    }
+    for (std::size_t i = 0; i < 10; i++) {
+        tree.insert_multi(&vec[i]);
+    }
+    // The batch is larger than the tree, so they're merged and rebuilt.
+    for (std::size_t i = 10; i < vec_size; i++) {
+        batch.push_back(&vec[i]);
+    }
+    tree.insert_batch(batch);
+    EXPECT_TRUE(validate(tree, vec));
+    EXPECT_EQ(tree.size(), vec_size);
+    for (std::size_t i = vec_size; i > 0; i--) {
+        EXPECT_EQ(tree.remove_leftmost(), &vec[i - 1]);
+    }
+}
+
+TEST(irwbt_test, remove_rightmost) {
+    irwbt_apple_t tree{};
+    std::vector<rsbt_apple> vec;
+    const std::size_t vec_size = 1000;
+    std::mt19937 gen(23);
+    std::uniform_int_distribution<uint64_t> dis(0, vec_size / 4);
+
+    vec.reserve(vec_size);
+    for (std::size_t i = 0; i < vec_size; i++) {
+        vec.emplace_back(dis(gen), i);
+    }
+    for (auto &i: vec) {
+        tree.insert_multi(&i);
+    }
+    while (!tree.empty()) {
+        rsbt_apple *back = tree.back();
+        rsbt_apple *prev = nullptr;
+        EXPECT_EQ(tree.remove_rightmost(prev), back);
+        EXPECT_EQ(prev, tree.back());
+        ASSERT_TRUE(validate(tree, vec));
+    }
+    EXPECT_EQ(tree.front(), nullptr);
+    EXPECT_EQ(tree.back(), nullptr);
+}
+
+TEST(irwbt_test, cached) {
+    irwbt_cached_apple_t tree{};
+    std::multiset<uint64_t> weights;
+    std::vector<rsbt_apple> vec;
+    std::vector<rsbt_apple *> batch;
+    const std::size_t vec_size = 4000;
+    std::mt19937 gen(23);
+    std::uniform_int_distribution<uint64_t> dis(0, vec_size / 4);
+    std::uniform_int_distribution<int> op_dis(0, 9);
+
+    EXPECT_EQ(tree.front(), nullptr);
+    EXPECT_EQ(tree.back(), nullptr);
+    vec.reserve(vec_size);
+    for (std::size_t i = 0; i < vec_size; i++) {
+        vec.emplace_back(dis(gen), i);
+    }
+    for (std::size_t i = 0; i < vec_size;) {
+        int op = op_dis(gen);
+        if ((op < 4) || weights.empty()) {
+            tree.insert_multi(&vec[i]);
+            weights.insert(vec[i++].weight);
+        } else if (op < 5) {
+            // Sequential nodes take the push_back_max path.
+            vec[i].weight = *weights.rbegin() + op_dis(gen);
+            tree.insert_multi(&vec[i]);
+            weights.insert(vec[i++].weight);
+        } else if (op < 6) {
+            batch.clear();
+            for (std::size_t j = 0; (j < 8) && (i < vec_size); j++, i++) {
+                batch.push_back(&vec[i]);
+                weights.insert(vec[i].weight);
+            }
+            tree.insert_batch(batch);
+        } else if (op < 7) {
+            EXPECT_EQ(tree.pop_front()->weight, *weights.begin());
+            weights.erase(weights.begin());
+        } else if (op < 8) {
+            EXPECT_EQ(tree.pop_back()->weight, *weights.rbegin());
+            weights.erase(std::prev(weights.end()));
+        } else {
+            uint64_t weight = dis(gen);
+            rsbt_apple *node = tree.remove(weight);
+            if (node != nullptr) {
+                EXPECT_EQ(node->weight, weight);
+                weights.erase(weights.find(weight));
+            } else {
+                EXPECT_EQ(weights.count(weight), 0);
+            }
+        }
+        ASSERT_EQ(tree.size(), weights.size());
+        if (weights.empty()) {
+            EXPECT_EQ(tree.front(), nullptr);
+            EXPECT_EQ(tree.back(), nullptr);
+        } else {
+            ASSERT_EQ(tree.front()->weight, *weights.begin());
+            ASSERT_EQ(tree.back()->weight, *weights.rbegin());
+            // They're the exact end nodes, not only the equivalent ones.
+            ASSERT_TRUE(irwbt_apple_t::is_sentinel(tree.front()->left));
+            ASSERT_TRUE(irwbt_apple_t::is_sentinel(tree.back()->right));
+        }
+    }
+    EXPECT_TRUE(validate(tree, vec));
+    while (!tree.empty()) {
+        EXPECT_EQ(tree.pop_front()->weight, *weights.begin());
+        weights.erase(weights.begin());
+    }
+    EXPECT_EQ(tree.front(), nullptr);
+    EXPECT_EQ(tree.back(), nullptr);
+}
+
+TEST(irwbt_test, clear_and_dispose) {
+    irwbt_apple_t tree{};
+    const std::size_t vec_size = 1000;
+    std::mt19937 gen(23);
+    std::uniform_int_distribution<uint64_t> dis(0, vec_size / 4);
+
+    for (std::size_t i = 0; i < vec_size; i++) {
+        tree.insert_multi(new rsbt_apple{dis(gen), static_cast<int>(i)});
+    }
+    // The nodes are freed by the disposer, and they're disposed in order.
+    uint64_t last = 0;
+    std::size_t count = 0;
+    tree.clear_and_dispose([&last, &count](rsbt_apple *node) {
+        EXPECT_LE(last, node->weight);
+        last = node->weight;
+        count++;
+        delete node;
+    });
+    EXPECT_EQ(count, vec_size);
+    EXPECT_TRUE(tree.empty());
+    EXPECT_EQ(tree.size(), 0);
+}
+
+// The bounded top-K pattern of idepq, the max is evicted and the node is inserted in one descent.
+TEST(irwbt_test, cached_replace_max) {
+    irwbt_cached_apple_t tree{};
+    std::multiset<uint64_t> weights;
+    std::vector<rsbt_apple> vec;
+    const std::size_t vec_size = 4000;
+    const std::size_t capacity = 200;
+    std::mt19937 gen(23);
+    std::uniform_int_distribution<uint64_t> dis(0, vec_size / 8);
+
+    vec.reserve(vec_size);
+    for (std::size_t i = 0; i < vec_size; i++) {
+        vec.emplace_back(dis(gen), i);
+    }
+    for (std::size_t i = 0; i < capacity; i++) {
+        tree.insert_multi(&vec[i]);
+        weights.insert(vec[i].weight);
+    }
+    std::size_t replaced = 0;
+    for (std::size_t i = capacity; i < vec_size; i++) {
+        if (!(vec[i] < *tree.back())) {
+            continue;
+        }
+        rsbt_apple *max = tree.replace_max(&vec[i]);
+        ASSERT_EQ(max->weight, *weights.rbegin());
+        weights.erase(std::prev(weights.end()));
+        weights.insert(vec[i].weight);
+        replaced++;
+        ASSERT_EQ(tree.size(), capacity);
+        ASSERT_EQ(tree.front()->weight, *weights.begin());
+        ASSERT_EQ(tree.back()->weight, *weights.rbegin());
+        ASSERT_TRUE(irwbt_cached_apple_t::is_sentinel(tree.back()->right));
+        ASSERT_TRUE(validate(tree, vec));
+    }
+    EXPECT_GT(replaced, 0);
+    // A single node is replaced by a smaller one.
+    tree.clear();
+    rsbt_apple a0{10, 0};
+    rsbt_apple a1{5, 1};
+    tree.insert_multi(&a0);
+    EXPECT_EQ(tree.replace_max(&a1), &a0);
+    EXPECT_EQ(tree.front(), &a1);
+    EXPECT_EQ(tree.back(), &a1);
+    EXPECT_EQ(tree.size(), 1);
+}
+
+TEST(irwbt_test, cached_clear_and_dispose) {
+    irwbt_cached_apple_t tree{};
+    rsbt_apple a0{500, 0};
+    rsbt_apple a1{501, 1};
+    std::size_t count = 0;
+
+    tree.insert_multi(&a1);
+    tree.insert_multi(&a0);
+    tree.clear_and_dispose([&count](rsbt_apple *) { count++; });
+    EXPECT_EQ(count, 2);
+    EXPECT_TRUE(tree.empty());
+    EXPECT_EQ(tree.front(), nullptr);
+    EXPECT_EQ(tree.back(), nullptr);
+}
+
+// Many nodes share a few keys, and each one is erased by itself in a random order.
+template <typename Tree>
+static void erase_duplicates() {
+    Tree tree{};
+    std::vector<rsbt_apple> vec;
+    std::vector<rsbt_apple *> order;
+    const std::size_t vec_size = 4000;
+    std::mt19937 gen(23);
+    std::uniform_int_distribution<uint64_t> dis(0, 7);
+
+    vec.reserve(vec_size);
+    for (std::size_t i = 0; i < vec_size; i++) {
+        vec.emplace_back(dis(gen), i);
+    }
+    for (auto &i: vec) {
+        tree.insert_multi(&i);
+        order.push_back(&i);
+    }
+    ASSERT_TRUE(validate(tree, vec));
+    std::shuffle(order.begin(), order.end(), gen);
+    for (std::size_t i = 0; i < vec_size; i++) {
+        ASSERT_TRUE(tree.erase(order[i]));
+        EXPECT_EQ(tree.size(), vec_size - i - 1);
+        if (i % 100 == 0) {
+            EXPECT_FALSE(tree.erase(order[i]));
+            ASSERT_TRUE(validate(tree, vec));
+            // The others are still there.
+            std::size_t count = 0;
+            tree.for_each([&count](const rsbt_apple &) { count++; });
+            EXPECT_EQ(count, tree.size());
+        }
+    }
+    EXPECT_TRUE(tree.empty());
+}
+
+TEST(irwbt_test, erase) {
+    irwbt_apple_t tree{};
+    rsbt_apple a0{500, 0};
+    rsbt_apple a1{500, 1};
+    rsbt_apple a2{500, 2};
+    rsbt_apple a3{501, 3};
+
+    tree.insert_multi(&a0);
+    tree.insert_multi(&a1);
+    tree.insert_multi(&a3);
+    EXPECT_FALSE(tree.erase(&a2));
+    EXPECT_TRUE(tree.erase(&a1));
+    EXPECT_FALSE(tree.erase(&a1));
+    EXPECT_EQ(tree.size(), 2);
+    EXPECT_EQ(tree.find(500), &a0);
+    EXPECT_TRUE(tree.erase(&a3));
+    EXPECT_TRUE(tree.erase(&a0));
+    EXPECT_TRUE(tree.empty());
+}
+
+TEST(irwbt_test, erase_duplicates) {
+    erase_duplicates<irwbt_apple_t>();
+}
+
+TEST(irwbt_test, erase_address_tiebreak) {
+    erase_duplicates<irwbt_tiebreak_apple_t>();
+
+    irwbt_tiebreak_apple_t tree{};
+    rsbt_apple a0{500, 0};
+    rsbt_apple a1{500, 1};
+    tree.insert_multi(&a0);
+    tree.insert_multi(&a1);
+    // A lookup by the key finds any one of the equivalent nodes.
+    EXPECT_EQ(tree.find(500)->weight, 500);
+    EXPECT_EQ(tree.lower_bound(500), std::min(&a0, &a1));
+    EXPECT_TRUE(tree.erase(&a1));
+    EXPECT_EQ(tree.find(500), &a0);
+}
+
+TEST(irwbt_test, cached_erase) {
+    irwbt_cached_apple_t tree{};
+    rsbt_apple a0{500, 0};
+    rsbt_apple a1{500, 1};
+    rsbt_apple a2{501, 2};
+    rsbt_apple a3{501, 3};
+
+    tree.insert_multi(&a0);
+    tree.insert_multi(&a1);
+    tree.insert_multi(&a2);
+    tree.insert_multi(&a3);
+    EXPECT_TRUE(tree.erase(&a0));
+    EXPECT_EQ(tree.front(), &a1);
+    EXPECT_TRUE(tree.erase(&a3));
+    EXPECT_EQ(tree.back(), &a2);
+    EXPECT_FALSE(tree.erase(&a3));
+    EXPECT_TRUE(tree.erase(&a1));
+    EXPECT_TRUE(tree.erase(&a2));
+    EXPECT_EQ(tree.front(), nullptr);
+    EXPECT_EQ(tree.back(), nullptr);
+}
+
+static_assert(uit::detail::wbt_balance_checker<3, 1, 2, 1>::is_legal());
+static_assert(uit::detail::wbt_balance_checker<5, 2, 3, 2>::is_legal());
+static_assert(!uit::detail::wbt_balance_checker<4, 1, 2, 1>::is_legal());
+static_assert(!uit::detail::wbt_balance_checker<3, 1, 3, 1>::is_legal());
+static_assert(!uit::detail::wbt_balance_checker<2, 1, 2, 1>::is_legal());
+
+// Runs every operation that changes the shape and validates the balance after it, the checker
+// doesn't model the top-down rebalancing, push_back_max, insert_batch or merge, see [2] in
+// wbt_balance.hpp.
+template <typename Delta, typename Gamma>
+static void balance_policy() {
+    using balance_t = uit::wbt_balance<Delta, Gamma>;
+    using tree_t =
+        uit::irwbt<&rsbt_apple::right, &rsbt_apple::left, &rsbt_apple::size, std::less<>, balance_t>;
+    tree_t tree{};
+    tree_t other{};
+    std::vector<rsbt_apple> vec;
+    std::vector<rsbt_apple *> batch;
+    const std::size_t vec_size = 4000;
+    const std::size_t step = vec_size / 8;
+    std::mt19937 gen(23);
+    std::uniform_int_distribution<uint64_t> dis(0, vec_size / 4);
+    auto valid = [&vec, &tree]() { return validate<tree_t, balance_t>(tree, vec); };
+
+    vec.reserve(vec_size);
+    for (std::size_t i = 0; i < vec_size; i++) {
+        vec.emplace_back(dis(gen), i);
+    }
+    std::size_t i = 0;
+    for (; i < step; i++) {
+        tree.insert_multi(&vec[i]);
+        ASSERT_TRUE(valid());
+    }
+    for (; i < step * 2; i++) {
+        tree.insert_multi_with_queue(&vec[i]);
+    }
+    ASSERT_TRUE(valid());
+    // The max side only grows, so the right spine is rebalanced on every push.
+    for (; i < step * 3; i++) {
+        vec[i].weight = vec_size + i;
+        tree.push_back_max(&vec[i]);
+        ASSERT_TRUE(valid());
+    }
+    // A small batch goes through the partition, a large one is rebuilt.
+    for (; i < step * 3 + 16; i++) {
+        batch.push_back(&vec[i]);
+    }
+    tree.insert_batch(batch);
+    ASSERT_TRUE(valid());
+    batch.clear();
+    for (; i < step * 5; i++) {
+        batch.push_back(&vec[i]);
+    }
+    tree.insert_batch(batch);
+    ASSERT_TRUE(valid());
+    // Merge a small tree and a tree of the same size.
+    for (; i < step * 5 + 20; i++) {
+        other.insert_multi(&vec[i]);
+    }
+    tree.merge(other);
+    ASSERT_TRUE(valid());
+    for (; i < vec_size; i++) {
+        other.insert_multi(&vec[i]);
+    }
+    tree.merge(other);
+    ASSERT_TRUE(valid());
+    ASSERT_EQ(tree.size(), vec_size);
+
+    std::vector<rsbt_apple *> order;
+    for (auto &e: vec) {
+        order.push_back(&e);
+    }
+    std::shuffle(order.begin(), order.end(), gen);
+    for (std::size_t k = 0; !order.empty(); k++) {
+        if (k % 4 == 0) {
+            order.erase(std::find(order.begin(), order.end(), tree.remove_leftmost()));
+        } else if (k % 4 == 1) {
+            order.erase(std::find(order.begin(), order.end(), tree.remove_rightmost()));
+        } else {
+            ASSERT_TRUE(tree.erase(order.back()));
+            order.pop_back();
+        }
+        if ((k % 16 == 0) || (tree.size() < 64)) {
+            ASSERT_TRUE(valid());
+        }
+    }
+    EXPECT_TRUE(tree.empty());
+}
+
+TEST(irwbt_test, balance_policy) {
+    balance_policy<std::ratio<3>, std::ratio<2>>();
+}
+
+// The other legal pairs on the grid of quarters, DELTA in [1, 6] and GAMMA in (0, 4], as accepted
+// by the checker.
+TEST(irwbt_test, balance_policy_grid) {
+    balance_policy<std::ratio<10, 4>, std::ratio<6, 4>>();
+    balance_policy<std::ratio<11, 4>, std::ratio<6, 4>>();
+    balance_policy<std::ratio<11, 4>, std::ratio<7, 4>>();
+    balance_policy<std::ratio<12, 4>, std::ratio<6, 4>>();
+    balance_policy<std::ratio<12, 4>, std::ratio<7, 4>>();
+    balance_policy<std::ratio<13, 4>, std::ratio<6, 4>>();
+    balance_policy<std::ratio<13, 4>, std::ratio<7, 4>>();
+    balance_policy<std::ratio<13, 4>, std::ratio<8, 4>>();
+    balance_policy<std::ratio<13, 4>, std::ratio<9, 4>>();
+    balance_policy<std::ratio<14, 4>, std::ratio<6, 4>>();
+    balance_policy<std::ratio<14, 4>, std::ratio<7, 4>>();
+    balance_policy<std::ratio<14, 4>, std::ratio<8, 4>>();
+    balance_policy<std::ratio<14, 4>, std::ratio<9, 4>>();
+    balance_policy<std::ratio<14, 4>, std::ratio<10, 4>>();
+    balance_policy<std::ratio<15, 4>, std::ratio<6, 4>>();
+    balance_policy<std::ratio<15, 4>, std::ratio<7, 4>>();
+    balance_policy<std::ratio<15, 4>, std::ratio<8, 4>>();
+    balance_policy<std::ratio<15, 4>, std::ratio<9, 4>>();
+    balance_policy<std::ratio<15, 4>, std::ratio<10, 4>>();
+    balance_policy<std::ratio<15, 4>, std::ratio<11, 4>>();
+}
+
+static std::size_t compare_count = 0;
+
+struct counting_compare : str_apple_compare {
+    template <typename A, typename B>
+    std::strong_ordering operator()(const A &a, const B &b) const noexcept {
+        compare_count++;
+        return key(a) <=> key(b);
+    }
+};
+
+// A three-way comparator is called once per level by the lookups.
+TEST(irwbt_test, three_way_compare) {
+    using tree_t = uit::irwbt<&str_apple::right, &str_apple::left, &str_apple::size, counting_compare>;
+    tree_t tree{};
+    std::vector<str_apple> vec;
+    const std::size_t vec_size = 1000;
+    std::mt19937 gen(23);
+
+    vec.reserve(vec_size);
+    for (std::size_t i = 0; i < vec_size; i++) {
+        vec.emplace_back("key-" + std::to_string(i * 7 % vec_size), i);
+    }
+    std::shuffle(vec.begin(), vec.end(), gen);
+    for (auto &i: vec) {
+        tree.insert_multi(&i);
+    }
+    for (auto &i: vec) {
+        compare_count = 0;
+        EXPECT_EQ(tree.find(std::string_view(i.name)), &i);
+        EXPECT_LE(compare_count, tree.height());
+    }
+    compare_count = 0;
+    EXPECT_EQ(tree.find(std::string_view("key")), nullptr);
+    EXPECT_LE(compare_count, tree.height());
+    str_apple dup{vec[0].name, -1};
+    EXPECT_FALSE(tree.insert(&dup));
+    EXPECT_EQ(tree.size(), vec_size);
+}
+
+// std::less with operator<=> on the nodes.
+TEST(irwbt_test, spaceship_operator) {
+    using tree_t = uit::irwbt<&str_apple::right, &str_apple::left, &str_apple::size>;
+    tree_t tree{};
+    str_apple a0{"apple", 0};
+    str_apple a1{"banana", 1};
+    str_apple a2{"cherry", 2};
+    str_apple key{"banana", 3};
+
+    tree.insert_multi(&a2);
+    tree.insert_multi(&a0);
+    tree.insert_multi(&a1);
+    EXPECT_EQ(tree.find(key), &a1);
+    EXPECT_EQ(tree.lower_bound(key), &a1);
+}
+
+static void merge(std::size_t n, std::size_t m) {
+    irwbt_apple_t a{};
+    irwbt_apple_t b{};
+    std::vector<rsbt_apple> vec;
+    std::mt19937 gen(23);
+    std::uniform_int_distribution<uint64_t> dis(0, (n + m) / 4);
+
+    vec.reserve(n + m);
+    for (std::size_t i = 0; i < n + m; i++) {
+        vec.emplace_back(dis(gen), i);
+    }
+    for (std::size_t i = 0; i < n + m; i++) {
+        (i < n ? a : b).insert_multi(&vec[i]);
+    }
+    a.merge(b);
+    EXPECT_TRUE(b.empty());
+    ASSERT_EQ(a.size(), n + m);
+    ASSERT_TRUE(validate(a, vec));
+    // The equivalent nodes are in the order of insertion, and the ones of b are after the ones of a.
+    const rsbt_apple *last = nullptr;
+    a.for_each([&last](rsbt_apple &node) {
+        if (last != nullptr) {
+            EXPECT_TRUE(
+                (last->weight < node.weight)
+                || ((last->weight == node.weight) && (last->sn < node.sn)));
+        }
+        last = &node;
+    });
+}
+
+TEST(irwbt_test, merge) {
+    merge(0, 0);
+    merge(0, 100);
+    merge(100, 0);
+    merge(1, 3000);
+    merge(3000, 1);
+    merge(1000, 10);
+    merge(10, 1000);
+    merge(500, 500);
+    merge(4000, 3000);
+}
+
+TEST(irwbt_test, merge_unique) {
+    irwbt_apple_t a{};
+    irwbt_apple_t b{};
+    std::vector<rsbt_apple> vec;
+    const std::size_t vec_size = 1000;
+
+    vec.reserve(vec_size * 2);
+    for (std::size_t i = 0; i < vec_size; i++) {
+        vec.emplace_back(i * 2, i);
+        a.insert(&vec.back());
+    }
+    for (std::size_t i = 0; i < vec_size; i++) {
+        vec.emplace_back(i * 3, vec_size + i);
+        b.insert(&vec.back());
+    }
+    // The multiples of 6 collide, and they stay in b.
+    a.merge_unique(b);
+    EXPECT_EQ(b.size(), (vec_size * 2 - 1) / 6 + 1);
+    EXPECT_EQ(a.size(), vec_size * 2 - b.size());
+    EXPECT_TRUE(validate(a, vec));
+    EXPECT_TRUE(validate(b, vec));
+    b.for_each([](rsbt_apple &node) {
+        EXPECT_EQ(node.weight % 6, 0);
+        EXPECT_GE(node.sn, static_cast<int>(vec_size));
+    });
+    a.for_each([vec_size](rsbt_apple &node) {
+        if ((node.weight % 6 == 0) && (node.weight < vec_size * 2)) {
+            EXPECT_LT(node.sn, static_cast<int>(vec_size));
+        }
+    });
+    for (uint64_t i = 0; i < vec_size * 2; i++) {
+        EXPECT_EQ(a.find(i) != nullptr, (i % 2 == 0) || (i % 3 == 0));
+    }
+}
+
+TEST(irwbt_test, merge_unique_on_collision) {
+    irwbt_apple_t a{};
+    irwbt_apple_t b{};
+    std::vector<rsbt_apple> vec;
+    const std::size_t vec_size = 1000;
+
+    vec.reserve(vec_size * 2);
+    for (std::size_t i = 0; i < vec_size; i++) {
+        vec.emplace_back(i * 2, i);
+        a.insert(&vec.back());
+    }
+    for (std::size_t i = 0; i < vec_size; i++) {
+        vec.emplace_back(i * 3, vec_size + i);
+        b.insert(&vec.back());
+    }
+    std::size_t collisions = 0;
+    a.merge_unique(b, [&collisions](rsbt_apple &kept, rsbt_apple &dropped) {
+        EXPECT_EQ(kept.weight, dropped.weight);
+        EXPECT_LT(kept.sn, static_cast<int>(vec_size));
+        EXPECT_GE(dropped.sn, static_cast<int>(vec_size));
+        collisions++;
+    });
+    EXPECT_TRUE(b.empty());
+    EXPECT_EQ(collisions, (vec_size * 2 - 1) / 6 + 1);
+    EXPECT_EQ(a.size(), vec_size * 2 - collisions);
+    EXPECT_TRUE(validate(a, vec));
+}
+
+TEST(irwbt_test, cached_merge) {
+    irwbt_cached_apple_t a{};
+    irwbt_cached_apple_t b{};
+    std::vector<rsbt_apple> vec;
+    const std::size_t vec_size = 1000;
+
+    vec.reserve(vec_size);
+    for (std::size_t i = 0; i < vec_size; i++) {
+        vec.emplace_back(i + 1, i);
+    }
+    for (std::size_t i = 0; i < vec_size; i++) {
+        (i % 4 == 0 ? b : a).insert(&vec[i]);
+    }
+    rsbt_apple dup{2, -1};
+    EXPECT_TRUE(b.insert(&dup));
+    // It collides with vec[1] of a, so b keeps it.
+    a.merge_unique(b);
+    EXPECT_EQ(a.size(), vec_size);
+    EXPECT_EQ(a.front(), &vec[0]);
+    EXPECT_EQ(a.back(), &vec[vec_size - 1]);
+    EXPECT_EQ(b.size(), 1);
+    EXPECT_EQ(b.front(), &dup);
+    EXPECT_EQ(b.back(), &dup);
+
+    irwbt_cached_apple_t c{};
+    c.merge(a);
+    EXPECT_TRUE(a.empty());
+    EXPECT_EQ(a.front(), nullptr);
+    c.merge(b);
+    EXPECT_EQ(c.size(), vec_size + 1);
+    EXPECT_EQ(c.front(), &vec[0]);
+    EXPECT_EQ(c.back(), &vec[vec_size - 1]);
+    // The equivalent node of the other tree goes after.
+    EXPECT_EQ(c.pop_front(), &vec[0]);
+    EXPECT_EQ(c.pop_front(), &vec[1]);
+    EXPECT_EQ(c.pop_front(), &dup);
+}
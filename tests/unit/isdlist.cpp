@@ -3,6 +3,7 @@
 // SPDX-License-Identifier: BSD 3-Clause
 
 #include <algorithm>
+#include <vector>
 #include "gtest/gtest.h"
 #include "common/apple.hpp"
 #include "uit/isdlist.hpp"
@@ -293,4 +294,62 @@ TEST(isdlist_test, move_assign) {
             sn++;
         }
     }
-}
\ No newline at end of file
+}
+
+TEST(isdlist_test, clear_and_dispose) {
+    list_t list{};
+    node_t a0(500, 0);
+    node_t a1(501, 1);
+    node_t a2(502, 2);
+    std::vector<node_t *> disposed;
+
+    list.push_front(&a0);
+    list.push_front(&a1);
+    list.push_front(&a2);
+    list.clear_and_dispose([&disposed](node_t *node) {
+        disposed.push_back(node);
+        // The disposer may reuse the links.
+        node->right = nullptr;
+    });
+    EXPECT_TRUE(list.empty());
+    ASSERT_EQ(disposed.size(), 3);
+    for (int i = 0; i < 3; i++) {
+        EXPECT_EQ(disposed[i]->sn, 2 - i);
+    }
+    list.clear_and_dispose([](node_t *) { FAIL(); });
+}
+
+TEST(isdlist_test, splice_front) {
+    list_t list{};
+    list_t other{};
+    node_t a0(500, 0);
+    node_t a1(501, 1);
+    node_t a2(502, 2);
+    node_t a3(503, 3);
+
+    list.splice_front(other);
+    EXPECT_TRUE(list.empty());
+
+    other.push_front(&a3);
+    list.splice_front(other);
+    EXPECT_TRUE(other.empty());
+    EXPECT_EQ(&a3, &list.front());
+
+    other.push_front(&a2);
+    other.push_front(&a1);
+    list.splice_front(other);
+    EXPECT_TRUE(other.empty());
+    EXPECT_EQ(&a1, &list.front());
+    // The links to the left are fixed, so the nodes at the seam can be removed.
+    list_t::remove(&a3);
+    list_t::remove(&a1);
+    list.push_front(&a0);
+    std::vector<int> sns;
+    for (auto &i: list) {
+        sns.push_back(i.sn);
+    }
+    EXPECT_EQ(sns, (std::vector<int>{0, 2}));
+    EXPECT_EQ(list.pop_front(), &a0);
+    EXPECT_EQ(list.pop_front(), &a2);
+    EXPECT_TRUE(list.empty());
+}
@@ -0,0 +1,180 @@
+// SPDX-FileCopyrightText: 2025 TypeCombinator <typecombinator@foxmail.com>
+//
+// SPDX-License-Identifier: BSD 3-Clause
+
+#include <uit/isplay_tree.hpp>
+#include <vector>
+#include <random>
+#include <gtest/gtest.h>
+#include <common/apple.hpp>
+
+using isplay_apple_t = uit::isplay_tree<&rsbt_apple::right, &rsbt_apple::left>;
+
+// Returns the size of the subtree, or -1 if the order is violated. The order is checked by an
+// in-order walk with an explicit stack, since the tree may be a long list.
+static long validate(const rsbt_apple *root) {
+    std::vector<const rsbt_apple *> stack;
+    const rsbt_apple *last = nullptr;
+    long size = 0;
+    while ((root != nullptr) || !stack.empty()) {
+        while (root != nullptr) {
+            stack.push_back(root);
+            root = root->left;
+        }
+        root = stack.back();
+        stack.pop_back();
+        if ((last != nullptr) && (root->weight < last->weight)) {
+            return -1;
+        }
+        last = root;
+        size++;
+        root = root->right;
+    }
+    return size;
+}
+
+TEST(isplay_tree_test, empty) {
+    isplay_apple_t tree{};
+    EXPECT_TRUE(tree.empty());
+    EXPECT_EQ(tree.size(), 0);
+    EXPECT_EQ(tree.find(1), nullptr);
+    EXPECT_EQ(tree.remove(1), nullptr);
+}
+
+TEST(isplay_tree_test, insert_multi) {
+    isplay_apple_t tree{};
+    std::vector<rsbt_apple> vec;
+    const std::size_t vec_size = 1000;
+    std::mt19937 gen(23);
+    std::uniform_int_distribution<uint64_t> dis(0, vec_size / 4);
+
+    vec.reserve(vec_size);
+    for (std::size_t i = 0; i < vec_size; i++) {
+        vec.emplace_back(dis(gen), i);
+    }
+    for (auto &i: vec) {
+        tree.insert_multi(&i);
+    }
+    EXPECT_EQ(tree.size(), vec_size);
+    for (auto &i: vec) {
+        // The found node is splayed to the root.
+        const rsbt_apple *root = tree.find(i.weight);
+        ASSERT_NE(root, nullptr);
+        EXPECT_EQ(root->weight, i.weight);
+        ASSERT_EQ(validate(root), static_cast<long>(vec_size));
+    }
+    EXPECT_EQ(tree.find(vec_size), nullptr);
+}
+
+TEST(isplay_tree_test, insert_unique) {
+    isplay_apple_t tree{};
+    rsbt_apple a0{500, 0};
+    rsbt_apple a1{501, 1};
+    rsbt_apple a2{502, 2};
+    rsbt_apple a3{501, 3};
+
+    EXPECT_TRUE(tree.insert(&a2));
+    EXPECT_TRUE(tree.insert(&a0));
+    EXPECT_TRUE(tree.insert(&a1));
+    EXPECT_FALSE(tree.insert(&a3));
+    EXPECT_EQ(tree.size(), 3);
+    EXPECT_EQ(tree.find(501), &a1);
+    EXPECT_EQ(tree.find(503), nullptr);
+    EXPECT_EQ(validate(tree.find(500)), 3);
+}
+
+TEST(isplay_tree_test, remove_leftmost) {
+    isplay_apple_t tree{};
+    std::vector<rsbt_apple> vec;
+    const std::size_t vec_size = 1000;
+    std::mt19937 gen(23);
+    std::uniform_int_distribution<uint64_t> dis(0, vec_size / 4);
+
+    vec.reserve(vec_size);
+    for (std::size_t i = 0; i < vec_size; i++) {
+        vec.emplace_back(dis(gen), i);
+    }
+    for (auto &i: vec) {
+        tree.insert_multi(&i);
+    }
+    uint64_t last = 0;
+    std::size_t count = 0;
+    while (!tree.empty()) {
+        const rsbt_apple *node = tree.remove_leftmost();
+        EXPECT_LE(last, node->weight);
+        last = node->weight;
+        count++;
+    }
+    EXPECT_EQ(count, vec_size);
+    EXPECT_EQ(tree.size(), 0);
+}
+
+TEST(isplay_tree_test, remove) {
+    isplay_apple_t tree{};
+    std::vector<rsbt_apple> vec;
+    const std::size_t vec_size = 1000;
+
+    vec.reserve(vec_size);
+    for (std::size_t i = 0; i < vec_size; i++) {
+        // 7 and 1000 are coprime, so the weights are a permutation.
+        vec.emplace_back(i * 7 % vec_size, i);
+    }
+    for (auto &i: vec) {
+        tree.insert_multi(&i);
+    }
+    for (uint64_t i = 0; i < vec_size; i += 2) {
+        const rsbt_apple *node = tree.remove(i);
+        ASSERT_NE(node, nullptr);
+        EXPECT_EQ(node->weight, i);
+        EXPECT_EQ(tree.remove(i), nullptr);
+    }
+    EXPECT_EQ(tree.size(), vec_size / 2);
+    for (uint64_t i = 1; i < vec_size; i += 2) {
+        EXPECT_EQ(tree.find(i)->weight, i);
+    }
+    EXPECT_EQ(validate(tree.find(1)), static_cast<long>(vec_size / 2));
+}
+
+TEST(isplay_tree_test, sequential) {
+    isplay_apple_t tree{};
+    std::vector<rsbt_apple> vec;
+    const std::size_t vec_size = 100000;
+
+    vec.reserve(vec_size);
+    for (std::size_t i = 0; i < vec_size; i++) {
+        vec.emplace_back(i, i);
+    }
+    // The tree becomes a list, the next lookups must not overflow the stack.
+    for (auto &i: vec) {
+        tree.insert_multi(&i);
+    }
+    EXPECT_EQ(tree.find(0), &vec[0]);
+    EXPECT_EQ(tree.find(vec_size - 1), &vec[vec_size - 1]);
+    for (std::size_t i = 0; i < vec_size; i++) {
+        EXPECT_EQ(tree.remove_leftmost(), &vec[i]);
+    }
+    EXPECT_TRUE(tree.empty());
+}
+
+TEST(isplay_tree_test, clear_and_dispose) {
+    isplay_apple_t tree{};
+    const std::size_t vec_size = 1000;
+    std::mt19937 gen(23);
+    std::uniform_int_distribution<uint64_t> dis(0, vec_size / 4);
+
+    for (std::size_t i = 0; i < vec_size; i++) {
+        tree.insert_multi(new rsbt_apple{dis(gen), static_cast<int>(i)});
+    }
+    // The nodes are freed by the disposer, and they're disposed in order.
+    uint64_t last = 0;
+    std::size_t count = 0;
+    tree.clear_and_dispose([&last, &count](rsbt_apple *node) {
+        EXPECT_LE(last, node->weight);
+        last = node->weight;
+        count++;
+        delete node;
+    });
+    EXPECT_EQ(count, vec_size);
+    EXPECT_TRUE(tree.empty());
+    EXPECT_EQ(tree.size(), 0);
+}
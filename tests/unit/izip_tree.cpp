@@ -0,0 +1,219 @@
+// SPDX-FileCopyrightText: 2025 TypeCombinator <typecombinator@foxmail.com>
+//
+// SPDX-License-Identifier: BSD 3-Clause
+
+#include <uit/izip_tree.hpp>
+#include <vector>
+#include <random>
+#include <cmath>
+#include <gtest/gtest.h>
+#include <common/apple.hpp>
+
+using izip_apple_t = uit::izip_tree<
+    &zip_apple::right,
+    &zip_apple::left,
+    &zip_apple::rank,
+    std::less<>,
+    &zip_apple::size>;
+using izip_nosize_apple_t = uit::izip_tree<&zip_apple::right, &zip_apple::left, &zip_apple::rank>;
+
+// Returns the size of the subtree, or -1 if any property of the zip tree is violated.
+template <typename Tree>
+static long validate_subtree(const zip_apple *root) {
+    if (Tree::is_sentinel(root)) {
+        return 0;
+    }
+    const zip_apple *left = root->left;
+    const zip_apple *right = root->right;
+    if (!Tree::is_sentinel(left) && ((root->weight < left->weight) || (left->rank >= root->rank))) {
+        return -1;
+    }
+    if (!Tree::is_sentinel(right) && ((right->weight < root->weight) || (right->rank > root->rank))) {
+        return -1;
+    }
+    long left_size = validate_subtree<Tree>(left);
+    long right_size = validate_subtree<Tree>(right);
+    if ((left_size < 0) || (right_size < 0)) {
+        return -1;
+    }
+    long size = left_size + right_size + 1;
+    if constexpr (Tree::has_size) {
+        if (root->size != static_cast<size_t>(size)) {
+            return -1;
+        }
+    }
+    return size;
+}
+
+// The root is the topmost node of its key, so it's found by the key. It has the max rank, and it's
+// the smallest one among the nodes of the max rank.
+template <typename Tree>
+static bool validate(const Tree &tree, const std::vector<zip_apple> &vec) {
+    if (tree.empty()) {
+        return tree.size() == 0;
+    }
+    const zip_apple *root = nullptr;
+    for (auto &i: vec) {
+        const zip_apple *node = tree.find(i.weight);
+        if ((node != nullptr)
+            && ((root == nullptr) || (root->rank < node->rank)
+                || ((root->rank == node->rank) && (node->weight < root->weight)))) {
+            root = node;
+        }
+    }
+    return validate_subtree<Tree>(root) == static_cast<long>(tree.size());
+}
+
+TEST(izip_tree_test, empty) {
+    izip_apple_t tree{};
+    EXPECT_TRUE(tree.empty());
+    EXPECT_EQ(tree.size(), 0);
+    EXPECT_EQ(tree.at(0), nullptr);
+    EXPECT_TRUE(izip_apple_t::validate_sentinel());
+    EXPECT_TRUE(izip_nosize_apple_t::validate_sentinel());
+}
+
+TEST(izip_tree_test, insert_multi) {
+    izip_apple_t tree{};
+    std::vector<zip_apple> vec;
+    const std::size_t vec_size = 1000;
+    std::mt19937 gen(23);
+    std::uniform_int_distribution<uint64_t> dis(0, vec_size / 4);
+
+    vec.reserve(vec_size);
+    for (std::size_t i = 0; i < vec_size; i++) {
+        vec.emplace_back(dis(gen), i);
+    }
+    for (auto &i: vec) {
+        tree.insert_multi(&i);
+        if (i.sn % 100 == 0) {
+            ASSERT_TRUE(validate(tree, vec));
+        }
+    }
+    EXPECT_EQ(tree.size(), vec_size);
+    EXPECT_TRUE(validate(tree, vec));
+    EXPECT_LE(tree.height(), 4 * std::log2(vec_size));
+    for (std::size_t i = 1; i < vec_size; i++) {
+        EXPECT_LE(tree.at(i - 1)->weight, tree.at(i)->weight);
+    }
+    EXPECT_EQ(tree.at(vec_size), nullptr);
+    EXPECT_TRUE(izip_apple_t::validate_sentinel());
+}
+
+TEST(izip_tree_test, insert_sequential) {
+    izip_nosize_apple_t tree{};
+    std::vector<zip_apple> vec;
+    const std::size_t vec_size = 1000;
+
+    vec.reserve(vec_size);
+    for (std::size_t i = 0; i < vec_size; i++) {
+        vec.emplace_back(i, i);
+    }
+    for (auto &i: vec) {
+        tree.insert_multi(&i);
+    }
+    EXPECT_EQ(tree.size(), vec_size);
+    EXPECT_TRUE(validate(tree, vec));
+    EXPECT_LE(tree.height(), 4 * std::log2(vec_size));
+    for (std::size_t i = 0; i < vec_size; i++) {
+        EXPECT_EQ(tree.remove_leftmost(), &vec[i]);
+    }
+    EXPECT_TRUE(tree.empty());
+}
+
+TEST(izip_tree_test, insert_unique) {
+    izip_apple_t tree{};
+    zip_apple a0{500, 0};
+    zip_apple a1{501, 1};
+    zip_apple a2{502, 2};
+    zip_apple a3{501, 3};
+
+    EXPECT_TRUE(tree.insert(&a0));
+    EXPECT_TRUE(tree.insert(&a1));
+    EXPECT_TRUE(tree.insert(&a2));
+    EXPECT_FALSE(tree.insert(&a3));
+    EXPECT_EQ(tree.size(), 3);
+    EXPECT_EQ(tree.find(501), &a1);
+    EXPECT_EQ(tree.find(503), nullptr);
+}
+
+TEST(izip_tree_test, remove_leftmost) {
+    izip_apple_t tree{};
+    std::vector<zip_apple> vec;
+    const std::size_t vec_size = 1000;
+    std::mt19937 gen(23);
+    std::uniform_int_distribution<uint64_t> dis(0, vec_size / 4);
+
+    vec.reserve(vec_size);
+    for (std::size_t i = 0; i < vec_size; i++) {
+        vec.emplace_back(dis(gen), i);
+    }
+    for (auto &i: vec) {
+        tree.insert_multi(&i);
+    }
+    uint64_t last = 0;
+    std::size_t count = 0;
+    while (!tree.empty()) {
+        const zip_apple *node = tree.remove_leftmost();
+        EXPECT_LE(last, node->weight);
+        last = node->weight;
+        count++;
+        if (count % 100 == 0) {
+            ASSERT_TRUE(validate(tree, vec));
+        }
+    }
+    EXPECT_EQ(count, vec_size);
+    EXPECT_EQ(tree.size(), 0);
+    EXPECT_TRUE(izip_apple_t::validate_sentinel());
+}
+
+TEST(izip_tree_test, remove) {
+    izip_apple_t tree{};
+    std::vector<zip_apple> vec;
+    const std::size_t vec_size = 1000;
+
+    vec.reserve(vec_size);
+    for (std::size_t i = 0; i < vec_size; i++) {
+        // 7 and 1000 are coprime, so the weights are a permutation.
+        vec.emplace_back(i * 7 % vec_size, i);
+    }
+    for (auto &i: vec) {
+        tree.insert_multi(&i);
+    }
+    for (uint64_t i = 0; i < vec_size; i += 2) {
+        const zip_apple *node = tree.remove(i);
+        ASSERT_NE(node, nullptr);
+        EXPECT_EQ(node->weight, i);
+        EXPECT_EQ(tree.remove(i), nullptr);
+    }
+    EXPECT_EQ(tree.size(), vec_size / 2);
+    EXPECT_TRUE(validate(tree, vec));
+    for (uint64_t i = 1; i < vec_size; i += 2) {
+        EXPECT_EQ(tree.find(i)->weight, i);
+        EXPECT_EQ(tree.at(i / 2)->weight, i);
+    }
+    EXPECT_TRUE(izip_apple_t::validate_sentinel());
+}
+
+TEST(izip_tree_test, clear_and_dispose) {
+    izip_apple_t tree{};
+    const std::size_t vec_size = 1000;
+    std::mt19937 gen(23);
+    std::uniform_int_distribution<uint64_t> dis(0, vec_size / 4);
+
+    for (std::size_t i = 0; i < vec_size; i++) {
+        tree.insert_multi(new zip_apple{dis(gen), static_cast<int>(i)});
+    }
+    // The nodes are freed by the disposer, and they're disposed in order.
+    uint64_t last = 0;
+    std::size_t count = 0;
+    tree.clear_and_dispose([&last, &count](zip_apple *node) {
+        EXPECT_LE(last, node->weight);
+        last = node->weight;
+        count++;
+        delete node;
+    });
+    EXPECT_EQ(count, vec_size);
+    EXPECT_TRUE(tree.empty());
+    EXPECT_EQ(tree.size(), 0);
+}
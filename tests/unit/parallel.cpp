@@ -0,0 +1,117 @@
+// SPDX-FileCopyrightText: 2025 TypeCombinator <typecombinator@foxmail.com>
+//
+// SPDX-License-Identifier: BSD 3-Clause
+
+#include <uit/parallel.hpp>
+#include <uit/irwbt.hpp>
+#include <uit/irsbt.hpp>
+#include <vector>
+#include <random>
+#include <atomic>
+#include <stdexcept>
+#include <gtest/gtest.h>
+#include <common/apple.hpp>
+
+using irwbt_apple_t = uit::irwbt<&rsbt_apple::right, &rsbt_apple::left, &rsbt_apple::size>;
+using irsbt_apple_t = uit::irsbt<&rsbt_apple::right, &rsbt_apple::left, &rsbt_apple::size>;
+
+template <typename Tree>
+class parallel_test : public testing::Test {
+   protected:
+    void SetUp() override {
+        std::mt19937 gen(23);
+        std::uniform_int_distribution<uint64_t> dis(0, vec_size / 4);
+
+        vec.reserve(vec_size);
+        for (std::size_t i = 0; i < vec_size; i++) {
+            vec.emplace_back(dis(gen), i);
+        }
+        for (auto &i: vec) {
+            tree.insert_multi(&i);
+        }
+        tree.for_each([this](rsbt_apple &node) { order.push_back(&node); });
+    }
+
+    static constexpr std::size_t vec_size = 1000;
+    std::vector<rsbt_apple> vec;
+    std::vector<const rsbt_apple *> order;
+    Tree tree{};
+};
+
+using tree_types = testing::Types<irwbt_apple_t, irsbt_apple_t>;
+TYPED_TEST_SUITE(parallel_test, tree_types);
+
+TYPED_TEST(parallel_test, for_each_range) {
+    const std::size_t n = this->vec_size;
+    for (std::size_t first = 0; first <= n; first += 37) {
+        for (std::size_t last = first; last <= n; last += 53) {
+            std::vector<const rsbt_apple *> visited;
+            this->tree.for_each_range(first, last, [&visited](rsbt_apple &node) {
+                visited.push_back(&node);
+            });
+            ASSERT_EQ(visited.size(), last - first);
+            for (std::size_t i = first; i < last; i++) {
+                ASSERT_EQ(visited[i - first], this->order[i]);
+            }
+        }
+    }
+    std::size_t count = 0;
+    this->tree.for_each_range(0, n, [&count](rsbt_apple &) { count++; });
+    EXPECT_EQ(count, n);
+}
+
+TYPED_TEST(parallel_test, parallel_for_each) {
+    for (std::size_t threads: {0, 1, 3, 8, 2000}) {
+        std::vector<std::atomic<int>> visits(this->vec_size);
+        uit::parallel_for_each(
+            this->tree, [&visits](rsbt_apple &node) { visits[node.sn]++; }, threads);
+        for (auto &v: visits) {
+            ASSERT_EQ(v.load(), 1);
+        }
+    }
+    TypeParam empty{};
+    uit::parallel_for_each(empty, [](rsbt_apple &) { FAIL(); }, 4);
+}
+
+TYPED_TEST(parallel_test, parallel_reduce) {
+    uint64_t sum = 0;
+    this->tree.for_each([&sum](rsbt_apple &node) { sum += node.weight; });
+    for (std::size_t threads: {1, 4, 7}) {
+        uint64_t result = uit::parallel_reduce(
+            this->tree,
+            uint64_t{0},
+            [](uint64_t a, uint64_t b) { return a + b; },
+            [](const rsbt_apple &node) { return node.weight; },
+            threads);
+        EXPECT_EQ(result, sum);
+    }
+    // The concatenation isn't commutative, so the chunks must be folded in order.
+    auto concat = [](std::vector<int> a, std::vector<int> b) {
+        a.insert(a.end(), b.begin(), b.end());
+        return a;
+    };
+    auto sns = uit::parallel_reduce(
+        this->tree,
+        std::vector<int>{-1},
+        concat,
+        [](const rsbt_apple &node) { return std::vector<int>{node.sn}; },
+        5);
+    ASSERT_EQ(sns.size(), this->vec_size + 1);
+    EXPECT_EQ(sns[0], -1);
+    for (std::size_t i = 0; i < this->vec_size; i++) {
+        EXPECT_EQ(sns[i + 1], this->order[i]->sn);
+    }
+}
+
+TYPED_TEST(parallel_test, exception) {
+    EXPECT_THROW(
+        uit::parallel_for_each(
+            this->tree,
+            [](rsbt_apple &node) {
+                if (node.sn == 500) {
+                    throw std::runtime_error{"500"};
+                }
+            },
+            4),
+        std::runtime_error);
+}
@@ -0,0 +1,85 @@
+// SPDX-FileCopyrightText: 2025 TypeCombinator <typecombinator@foxmail.com>
+//
+// SPDX-License-Identifier: BSD 3-Clause
+
+#include <uit/irwbt.hpp>
+#include <uit/irsbt.hpp>
+#include <uit/snapshot.hpp>
+#include <vector>
+#include <random>
+#include <gtest/gtest.h>
+#include <common/apple.hpp>
+
+using irwbt_apple_t = uit::irwbt<&rsbt_apple::right, &rsbt_apple::left, &rsbt_apple::size>;
+using irsbt_apple_t = uit::irsbt<&rsbt_apple::right, &rsbt_apple::left, &rsbt_apple::size>;
+
+TEST(snapshot_test, empty) {
+    irwbt_apple_t tree{};
+    auto snapshot = uit::snapshot<&rsbt_apple::weight>(tree);
+
+    EXPECT_TRUE(snapshot.empty());
+    EXPECT_EQ(snapshot.size(), 0);
+    EXPECT_EQ(snapshot.find(0), nullptr);
+    EXPECT_EQ(snapshot.lower_bound(0), nullptr);
+}
+
+TEST(snapshot_test, irwbt) {
+    std::mt19937 gen(23);
+
+    for (std::size_t vec_size = 1; vec_size < 100; vec_size++) {
+        irwbt_apple_t tree{};
+        std::vector<rsbt_apple> vec;
+        std::uniform_int_distribution<uint64_t> dis(0, vec_size * 2);
+
+        vec.reserve(vec_size);
+        for (std::size_t i = 0; i < vec_size; i++) {
+            vec.emplace_back(dis(gen), i);
+        }
+        for (auto &i: vec) {
+            tree.insert_multi(&i);
+        }
+        auto snapshot = uit::snapshot<&rsbt_apple::weight>(tree);
+        EXPECT_EQ(snapshot.size(), vec_size);
+        for (uint64_t k = 0; k <= vec_size * 2 + 1; k++) {
+            const rsbt_apple *expected = tree.lower_bound(k);
+            const rsbt_apple *result = snapshot.lower_bound(k);
+            if (expected == nullptr) {
+                EXPECT_EQ(result, nullptr);
+            } else {
+                ASSERT_NE(result, nullptr);
+                EXPECT_EQ(result->weight, expected->weight);
+            }
+            if ((expected != nullptr) && (expected->weight == k)) {
+                ASSERT_NE(snapshot.find(k), nullptr);
+                EXPECT_EQ(snapshot.find(k)->weight, k);
+            } else {
+                EXPECT_EQ(snapshot.find(k), nullptr);
+            }
+        }
+    }
+}
+
+TEST(snapshot_test, irsbt_rebuild) {
+    irsbt_apple_t tree{};
+    rsbt_apple a0{500, 0};
+    rsbt_apple a1{502, 1};
+    rsbt_apple a2{504, 2};
+    uit::eytzinger_snapshot<&rsbt_apple::weight> snapshot{};
+
+    tree.insert_unique(&a0);
+    tree.insert_unique(&a1);
+    snapshot.rebuild(tree);
+    EXPECT_EQ(snapshot.find(502), &a1);
+    EXPECT_EQ(snapshot.find(504), nullptr);
+    EXPECT_EQ(snapshot.lower_bound(501), &a1);
+
+    tree.insert_unique(&a2);
+    snapshot.rebuild(tree);
+    EXPECT_EQ(snapshot.find(504), &a2);
+    EXPECT_EQ(snapshot.lower_bound(503), &a2);
+    EXPECT_EQ(snapshot.lower_bound(505), nullptr);
+
+    snapshot.clear();
+    EXPECT_TRUE(snapshot.empty());
+    EXPECT_EQ(snapshot.find(500), nullptr);
+}